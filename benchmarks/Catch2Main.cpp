@@ -17,7 +17,14 @@ int main (int argc, char* argv[])
 }
 
 #include "UI/ProPhatEditor.h"
+#include "helpers/benchmark_helpers.h"
+#include "helpers/perf_counters.h"
 #include "catch2/benchmark/catch_benchmark_all.hpp"
 #include "catch2/catch_test_macros.hpp"
 
 #include "Benchmarks.cpp"
+#include "ReverbBenchmarks.cpp"
+#include "ThroughputBenchmarks.cpp"
+#include "KernelBenchmarks.cpp"
+#include "MidiStressBenchmarks.cpp"
+#include "OscillatorQualityBenchmarks.cpp"
@@ -0,0 +1,231 @@
+//this file is included at the end of Catch2Main.cpp, like Benchmarks.cpp
+
+namespace KernelBenchmarks
+{
+constexpr auto sampleRate { 48000. };
+constexpr auto blockSize { 512 };
+const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, 2 };
+
+/** Runs kernel under the hardware counters, if they're available, and prints them per sample. */
+template <typename Kernel>
+static void reportPerfCounters (const std::string& name, Kernel& kernel)
+{
+    static PerfCounters counters;
+    if (! counters.isAvailable())
+        return;
+
+    constexpr auto numIterations { 1000 };
+
+    counters.start();
+    for (auto i = 0; i < numIterations; ++i)
+        kernel();
+    const auto values { counters.stop() };
+
+    const auto numSamples { (double) numIterations * blockSize };
+    std::cout << name << ": " << values.cycles / numSamples << " cycles/sample, "
+              << (values.cycles > 0 ? (double) values.instructions / (double) values.cycles : 0.) << " IPC, "
+              << values.cacheMisses / numSamples << " cache misses/sample, "
+              << values.branchMisses / numSamples << " branch misses/sample" << std::endl;
+}
+
+/** Every kernel processes one block of blockSize samples per call, and returns something that depends on
+ *  its output so it doesn't get optimised away.
+ */
+template <typename Kernel>
+static void benchmarkKernel (const std::string& name, Kernel&& kernel)
+{
+    BENCHMARK (name + ", " + std::to_string (blockSize) + " samples")
+    {
+        return kernel();
+    };
+
+    reportPerfCounters (name, kernel);
+}
+
+static juce::AudioBuffer<float> makeNoise()
+{
+    juce::AudioBuffer<float> noise (2, blockSize);
+    juce::Random             random (1234);
+    for (int c = 0; c < noise.getNumChannels(); ++c)
+        for (int i = 0; i < blockSize; ++i)
+            noise.setSample (c, i, random.nextFloat() * 2.f - 1.f);
+
+    return noise;
+}
+
+/** Runs an effect over noise, refilling the input every time so it doesn't process its own output over and over. */
+template <typename Effect>
+static void benchmarkEffect (const std::string& name, Effect& effect)
+{
+    const auto               noise { makeNoise() };
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    auto                     block { juce::dsp::AudioBlock<float> (buffer) };
+
+    benchmarkKernel (name, [&]
+    {
+        buffer.makeCopyOf (noise, true);
+        effect.process (juce::dsp::ProcessContextReplacing<float> (block));
+        return buffer.getSample (0, 0);
+    });
+}
+} // namespace KernelBenchmarks
+
+TEST_CASE ("Kernel performance")
+{
+    using namespace KernelBenchmarks;
+
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    auto                     block { juce::dsp::AudioBlock<float> (buffer) };
+
+    SECTION ("GainedOscillator")
+    {
+        const std::array<std::pair<OscShape::Values, const char*>, 5> shapes { {
+            { OscShape::saw, "saw" },
+            { OscShape::sawTri, "sawTri" },
+            { OscShape::triangle, "triangle" },
+            { OscShape::pulse, "pulse" },
+            { OscShape::noise, "noise" },
+        } };
+
+        for (const auto& [shape, shapeName] : shapes)
+        {
+            GainedOscillator<float> oscillator;
+            oscillator.prepare (spec);
+            oscillator.setOscShape (shape);
+            oscillator.setFrequency (220.f, true);
+
+            benchmarkKernel (std::string ("GainedOscillator ") + shapeName, [&]
+            {
+                //the oscillator adds to its output
+                buffer.clear();
+                oscillator.process (juce::dsp::ProcessContextReplacing<float> (block));
+                return buffer.getSample (0, blockSize - 1);
+            });
+        }
+
+        GainedOscillator<float> oscillator;
+        oscillator.prepare (spec);
+        oscillator.setFrequency (220.f, true);
+        oscillator.setSubOctaveGain (1.f);
+
+        benchmarkKernel ("GainedOscillator saw + sub octave", [&]
+        {
+            buffer.clear();
+            oscillator.process (juce::dsp::ProcessContextReplacing<float> (block));
+            return buffer.getSample (0, blockSize - 1);
+        });
+    }
+
+    SECTION ("PhatOscillators")
+    {
+        //the oscillators listen to the processor's state, with its default parameters
+        ProPhatProcessor        processor;
+        PhatOscillators<float> oscillators (processor.state);
+        oscillators.prepare (spec);
+        oscillators.updateOscFrequencies (Constants::middleCMidiNote, 1.f, 8192);
+
+        benchmarkKernel ("PhatOscillators", [&]
+        {
+            oscillators.prepareRender (blockSize);
+            return oscillators.process (0, blockSize).getSample (0, blockSize - 1);
+        });
+    }
+
+    SECTION ("PhatVoiceFilter")
+    {
+        //a cutoff sweep, since the voices compute the cutoff per sample
+        std::vector<float> cutoff ((size_t) blockSize);
+        for (size_t i = 0; i < cutoff.size(); ++i)
+            cutoff[i] = 200.f + 8000.f * (float) i / (float) blockSize;
+
+        const auto noise { makeNoise() };
+
+        for (const auto& [model, modelName] : { std::pair { FilterModel::eco, "eco" }, std::pair { FilterModel::standard, "standard" }, std::pair { FilterModel::analog, "analog" } })
+        {
+            PhatVoiceFilter<float> filter;
+            filter.prepare (spec);
+            filter.setModel (model);
+            filter.setResonance (.7f);
+
+            benchmarkKernel (std::string ("PhatVoiceFilter ") + modelName, [&]
+            {
+                buffer.makeCopyOf (noise, true);
+                filter.process (block, cutoff.data());
+                return buffer.getSample (0, blockSize - 1);
+            });
+        }
+    }
+
+    SECTION ("Amp envelope")
+    {
+        //the loop from ProPhatVoice::renderNextBlockTemplate(): the envelope, applied to each channel, and the peak follower
+        juce::ADSR ampADSR;
+        ampADSR.setSampleRate (sampleRate);
+        ampADSR.setParameters ({ Constants::defaultAmpA, Constants::defaultAmpD, Constants::defaultAmpS, Constants::defaultAmpR });
+        ampADSR.noteOn();
+
+        const auto noise { makeNoise() };
+        const auto outputLevelDecay { (float) std::exp (-1. / (Constants::voiceLevelHoldSeconds * sampleRate)) };
+        auto       outputLevel { 0.f };
+
+        benchmarkKernel ("Amp envelope", [&]
+        {
+            buffer.makeCopyOf (noise, true);
+
+            auto level { outputLevel };
+            for (auto i = 0; i < blockSize; ++i)
+            {
+                const auto ampEnv = ampADSR.getNextSample();
+                level *= outputLevelDecay;
+                for (size_t c = 0; c < block.getNumChannels(); ++c)
+                {
+                    auto& sample = block.getChannelPointer (c)[i];
+                    sample *= ampEnv;
+                    level = juce::jmax (level, std::abs (sample));
+                }
+            }
+            outputLevel = level;
+
+            return outputLevel;
+        });
+    }
+
+    SECTION ("Effects")
+    {
+        PhatVerbProcessor<float> verb;
+        verb.prepare (spec);
+        PhatVerbParameters<float> params;
+        params.roomSize = .5f;
+        verb.setParameters (params);
+        benchmarkEffect ("PhatVerb", verb);
+
+        juce::dsp::Chorus<float> chorus;
+        chorus.prepare (spec);
+        benchmarkEffect ("Chorus", chorus);
+
+        juce::dsp::Phaser<float> phaser;
+        phaser.prepare (spec);
+        benchmarkEffect ("Phaser", phaser);
+    }
+
+    SECTION ("Effect crossfade")
+    {
+        //the crossfader only runs while we switch effects, so we keep switching
+        EffectsCrossfadeProcessor<float> crossfader;
+        crossfader.prepare (spec);
+
+        const auto               noise { makeNoise() };
+        juce::AudioBuffer<float> previousEffectBuffer (2, blockSize);
+
+        benchmarkKernel ("Effect crossfade", [&]
+        {
+            if (crossfader.getCurrentEffectType() != EffectType::transitioning)
+                crossfader.changeEffect (crossfader.curEffect == EffectType::chorus ? EffectType::phaser : EffectType::chorus);
+
+            buffer.makeCopyOf (noise, true);
+            previousEffectBuffer.makeCopyOf (noise, true);
+            crossfader.process (previousEffectBuffer, juce::dsp::ProcessContextReplacing<float> (block));
+            return buffer.getSample (0, blockSize - 1);
+        });
+    }
+}
@@ -0,0 +1,144 @@
+//this file is included at the end of Catch2Main.cpp, like Benchmarks.cpp
+
+namespace MidiStress
+{
+constexpr auto sampleRate { 48000. };
+constexpr auto blockSize { 512 };
+constexpr auto numBlocks { 400 };
+
+/** Fills the midi buffer for the block starting at blockIndex. */
+using MidiGenerator = std::function<void (juce::MidiBuffer&, int blockIndex, juce::Random&)>;
+
+struct BlockTimes
+{
+    double meanMicroseconds;
+    double worstMicroseconds;
+    double p99Microseconds;
+};
+
+static BlockTimes measureBlockTimes (const MidiGenerator& generator)
+{
+    ProPhatProcessor processor;
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    juce::MidiBuffer         midi;
+    juce::Random             random (1234);
+    std::vector<double>      times;
+    times.reserve (numBlocks);
+
+    for (auto i = 0; i < numBlocks; ++i)
+    {
+        midi.clear();
+        generator (midi, i, random);
+
+        const auto start { BenchmarkClock::now() };
+        processor.processBlock (buffer, midi);
+        times.push_back (secondsSince (start) * 1e6);
+    }
+
+    const auto mean { std::accumulate (times.begin(), times.end(), 0.) / (double) times.size() };
+    std::sort (times.begin(), times.end());
+
+    return { mean, times.back(), times[(size_t) ((double) (times.size() - 1) * .99)] };
+}
+
+static void noteEverySample (juce::MidiBuffer& midi, int, juce::Random& random)
+{
+    //a note on, then a note off for a random note, on every sample
+    for (auto i = 0; i < blockSize; ++i)
+    {
+        const auto note { 24 + random.nextInt (84) };
+        midi.addEvent (i % 2 == 0 ? juce::MidiMessage::noteOn (1, note, (juce::uint8) 100) : juce::MidiMessage::noteOff (1, note), i);
+    }
+}
+
+static void noteClusters (juce::MidiBuffer& midi, int blockIndex, juce::Random&)
+{
+    //all 128 notes at once, released 4 blocks later
+    if (blockIndex % 8 == 0)
+        for (auto note = 0; note < 128; ++note)
+            midi.addEvent (juce::MidiMessage::noteOn (1, note, (juce::uint8) 100), 0);
+    else if (blockIndex % 8 == 4)
+        for (auto note = 0; note < 128; ++note)
+            midi.addEvent (juce::MidiMessage::noteOff (1, note), 0);
+}
+
+static void sustainFlood (juce::MidiBuffer& midi, int, juce::Random& random)
+{
+    //the sustain pedal goes up and down on every sample, while short notes keep coming in
+    for (auto i = 0; i < blockSize; ++i)
+    {
+        midi.addEvent (juce::MidiMessage::controllerEvent (1, 64, i % 2 == 0 ? 127 : 0), i);
+
+        if (i % 16 == 0)
+        {
+            const auto note { 24 + random.nextInt (84) };
+            midi.addEvent (juce::MidiMessage::noteOn (1, note, (juce::uint8) 100), i);
+            midi.addEvent (juce::MidiMessage::noteOff (1, note), juce::jmin (i + 8, blockSize - 1));
+        }
+    }
+}
+
+static void pitchWheelSweep (juce::MidiBuffer& midi, int blockIndex, juce::Random&)
+{
+    //a held chord, with the pitch wheel going back and forth over its whole range, one message per sample
+    if (blockIndex == 0)
+        for (auto i = 0; i < 8; ++i)
+            midi.addEvent (juce::MidiMessage::noteOn (1, 48 + 3 * i, (juce::uint8) 100), 0);
+
+    for (auto i = 0; i < blockSize; ++i)
+    {
+        const auto position { (blockIndex * blockSize + i) % 32768 };
+        midi.addEvent (juce::MidiMessage::pitchWheel (1, position < 16384 ? position : 32767 - position), i);
+    }
+}
+
+static void everything (juce::MidiBuffer& midi, int blockIndex, juce::Random& random)
+{
+    noteEverySample (midi, blockIndex, random);
+    noteClusters (midi, blockIndex, random);
+    sustainFlood (midi, blockIndex, random);
+    pitchWheelSweep (midi, blockIndex, random);
+}
+} // namespace MidiStress
+
+TEST_CASE ("MIDI stress")
+{
+    using namespace MidiStress;
+
+    const std::array<std::pair<const char*, MidiGenerator>, 5> scenarios { {
+        { "note on/off every sample", noteEverySample },
+        { "128-note clusters", noteClusters },
+        { "sustain pedal flood", sustainFlood },
+        { "pitch wheel sweep", pitchWheelSweep },
+        { "all of the above", everything },
+    } };
+
+    //a block has this long to render before we miss the deadline
+    const auto blockDeadlineMicroseconds { blockSize / sampleRate * 1e6 };
+    juce::Array<juce::var> results;
+
+    std::cout << "MIDI stress, " << blockSize << " samples @ " << sampleRate << " Hz, deadline " << blockDeadlineMicroseconds << " us\n";
+
+    for (const auto& [name, generator] : scenarios)
+    {
+        const auto times { measureBlockTimes (generator) };
+
+        std::cout << juce::String (name).paddedRight (' ', 28) << "mean " << juce::String (times.meanMicroseconds, 1).paddedLeft (' ', 8)
+                  << " us, p99 " << juce::String (times.p99Microseconds, 1).paddedLeft (' ', 8)
+                  << " us, worst " << juce::String (times.worstMicroseconds, 1).paddedLeft (' ', 8) << " us\n";
+
+        auto entry { std::make_unique<juce::DynamicObject>() };
+        entry->setProperty ("scenario", name);
+        entry->setProperty ("meanMicroseconds", times.meanMicroseconds);
+        entry->setProperty ("p99Microseconds", times.p99Microseconds);
+        entry->setProperty ("worstMicroseconds", times.worstMicroseconds);
+        entry->setProperty ("deadlineMicroseconds", blockDeadlineMicroseconds);
+        results.add (juce::var (entry.release()));
+
+        CHECK (std::isfinite (times.worstMicroseconds));
+    }
+
+    writeJsonReport ("midi_stress.json", "MIDI stress", results);
+}
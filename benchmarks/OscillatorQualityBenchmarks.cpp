@@ -0,0 +1,120 @@
+//this file is included at the end of Catch2Main.cpp, like Benchmarks.cpp
+
+namespace OscillatorQuality
+{
+constexpr auto fftOrder { 16 };
+constexpr auto fftSize { 1 << fftOrder };
+constexpr auto blockSize { 512 };
+
+//the blackman-harris main lobe is 4 bins wide on each side of a harmonic
+constexpr auto mainLobeBins { 4 };
+
+static void render (GainedOscillator<float>& oscillator, juce::AudioBuffer<float>& buffer)
+{
+    buffer.clear();
+
+    for (auto pos = 0; pos < buffer.getNumSamples(); pos += blockSize)
+    {
+        auto block { juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) pos, (size_t) juce::jmin (blockSize, buffer.getNumSamples() - pos)) };
+        oscillator.process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+}
+
+/** Everything that lands on a harmonic of the fundamental is signal, everything else is aliasing. For low notes
+ *  the harmonics' main lobes cover most of the spectrum, which hides some of the aliases, so take the ratio as
+ *  an upper bound there.
+ */
+static double getSignalToAliasRatioDb (const float* signal, double sampleRate, double frequency)
+{
+    std::vector<float> data (2 * fftSize, 0.f);
+    std::copy (signal, signal + fftSize, data.begin());
+
+    juce::dsp::WindowingFunction<float> window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+    window.multiplyWithWindowingTable (data.data(), (size_t) fftSize);
+
+    juce::dsp::FFT fft (fftOrder);
+    fft.performFrequencyOnlyForwardTransform (data.data(), true);
+
+    const auto binWidth { sampleRate / fftSize };
+    auto       harmonicEnergy { 0. };
+    auto       aliasEnergy { 0. };
+
+    //skipping dc
+    for (auto bin = mainLobeBins + 1; bin <= fftSize / 2; ++bin)
+    {
+        const auto binFrequency { bin * binWidth };
+        const auto harmonic { std::round (binFrequency / frequency) };
+        const auto energy { (double) data[(size_t) bin] * data[(size_t) bin] };
+
+        if (harmonic >= 1. && std::abs (binFrequency - harmonic * frequency) <= mainLobeBins * binWidth)
+            harmonicEnergy += energy;
+        else
+            aliasEnergy += energy;
+    }
+
+    return 10. * std::log10 (harmonicEnergy / std::max (aliasEnergy, 1e-30));
+}
+
+static double measureNsPerSample (GainedOscillator<float>& oscillator)
+{
+    constexpr auto numBlocks { 200 };
+
+    juce::AudioBuffer<float> buffer (1, blockSize);
+    auto                     block { juce::dsp::AudioBlock<float> (buffer) };
+
+    const auto start { BenchmarkClock::now() };
+    for (auto i = 0; i < numBlocks; ++i)
+        oscillator.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+    return secondsSince (start) * 1e9 / (numBlocks * blockSize);
+}
+} // namespace OscillatorQuality
+
+TEST_CASE ("Oscillator quality vs cost")
+{
+    using namespace OscillatorQuality;
+
+    const std::array<std::pair<OscShape::Values, const char*>, 4> shapes { {
+        { OscShape::saw, "saw" },
+        { OscShape::sawTri, "sawTri" },
+        { OscShape::triangle, "triangle" },
+        { OscShape::pulse, "pulse" },
+    } };
+
+    //a bit of extra signal at the start, which we skip so the gain has settled
+    constexpr auto numSkippedSamples { 4096 };
+    juce::AudioBuffer<float> buffer (1, fftSize + numSkippedSamples);
+
+    juce::StringArray csv { "shape,midiNote,frequencyHz,sampleRate,nsPerSample,signalToAliasDb" };
+    std::cout << "shape      note   frequency  sample rate  ns/sample  SAR dB\n";
+
+    for (const auto& [shape, shapeName] : shapes)
+        for (const auto sampleRate : { 44100., 48000., 96000., 192000. })
+            for (auto midiNote = 24; midiNote <= 108; midiNote += 12)
+            {
+                const auto frequency { Helpers::getMidiNoteInHertz (static_cast<float> (midiNote)) };
+
+                GainedOscillator<float> oscillator;
+                oscillator.prepare ({ sampleRate, (juce::uint32) blockSize, 1 });
+                oscillator.setOscShape (shape);
+                oscillator.setFrequency (frequency, true);
+
+                render (oscillator, buffer);
+                const auto sarDb { getSignalToAliasRatioDb (buffer.getReadPointer (0, numSkippedSamples), sampleRate, frequency) };
+                const auto nsPerSample { measureNsPerSample (oscillator) };
+
+                std::cout << juce::String (shapeName).paddedRight (' ', 9) << juce::String (midiNote).paddedLeft (' ', 6)
+                          << juce::String (frequency, 1).paddedLeft (' ', 12) << juce::String (sampleRate, 0).paddedLeft (' ', 13)
+                          << juce::String (nsPerSample, 2).paddedLeft (' ', 11) << juce::String (sarDb, 1).paddedLeft (' ', 8) << "\n";
+
+                csv.add (juce::StringArray { shapeName, juce::String (midiNote), juce::String (frequency, 3), juce::String (sampleRate, 0),
+                                             juce::String (nsPerSample, 3), juce::String (sarDb, 2) }
+                             .joinIntoString (","));
+
+                CHECK (std::isfinite (sarDb));
+            }
+
+    const auto file { getBenchmarkOutputFile ("oscillator_quality.csv") };
+    [[maybe_unused]] const auto success { file.replaceWithText (csv.joinIntoString ("\n") + "\n") };
+    std::cout << "Wrote " << file.getFullPathName() << std::endl;
+}
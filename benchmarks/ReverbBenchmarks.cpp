@@ -0,0 +1,41 @@
+//this file is included at the end of Catch2Main.cpp, like Benchmarks.cpp
+
+template <typename ReverbProcessor>
+static void benchmarkReverb (const std::string& name, double sampleRate)
+{
+    constexpr auto blockSize { 512 };
+
+    ReverbProcessor reverb;
+    reverb.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+
+    PhatVerbParameters<float> params;
+    params.roomSize = .5f;
+    reverb.setParameters (params);
+
+    juce::AudioBuffer<float> noise (2, blockSize), buffer (2, blockSize);
+    juce::Random             random (1234);
+    for (int c = 0; c < noise.getNumChannels(); ++c)
+        for (int i = 0; i < blockSize; ++i)
+            noise.setSample (c, i, random.nextFloat() * 2.f - 1.f);
+
+    auto       block { juce::dsp::AudioBlock<float> (buffer) };
+    const auto context { juce::dsp::ProcessContextReplacing<float> (block) };
+
+    BENCHMARK (name + " @ " + std::to_string ((int) sampleRate) + " Hz, " + std::to_string (blockSize) + " samples")
+    {
+        //refill the input every time, otherwise we'd be feeding the reverb its own output over and over
+        buffer.makeCopyOf (noise, true);
+        reverb.process (context);
+        return buffer.getSample (0, 0);
+    };
+}
+
+TEST_CASE ("Reverb performance")
+{
+    for (const auto sampleRate : { 44100., 96000., 192000. })
+    {
+        benchmarkReverb<PhatVerbProcessor<float>> ("PhatVerb", sampleRate);
+        benchmarkReverb<PhatVerbProcessor<float, PhatFdnVerb<float, 8, FdnMixing::householder>>> ("FDN 8 householder", sampleRate);
+        benchmarkReverb<PhatVerbProcessor<float, PhatFdnVerb<float, 16, FdnMixing::hadamard>>> ("FDN 16 hadamard", sampleRate);
+    }
+}
@@ -0,0 +1,105 @@
+//this file is included at the end of Catch2Main.cpp, like Benchmarks.cpp
+
+struct ThroughputConfig
+{
+    int                 numVoices;
+    int                 blockSize;
+    double              sampleRate;
+    bool                doublePrecision;
+    const EffectConfig& effect;
+    bool                automationStorm;
+};
+
+struct ThroughputResult
+{
+    double nsPerSample;
+
+    //processing time over audio time, so under 1 means faster than real time
+    double realTimeFactor;
+};
+
+template <std::floating_point T>
+static ThroughputResult measureThroughput (const ThroughputConfig& config)
+{
+    //we get through the attacks and the crossfade to the effect before measuring
+    constexpr auto warmUpSeconds { .2 };
+    constexpr auto measuredSeconds { .5 };
+
+    ProPhatProcessor processor;
+    selectEffect (processor, config.effect);
+    processor.setProcessingPrecision (std::is_same_v<T, double> ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+    processor.prepareToPlay (config.sampleRate, config.blockSize);
+
+    juce::AudioBuffer<T> buffer (2, config.blockSize);
+    juce::MidiBuffer     midi;
+    juce::Random         random (1234);
+
+    //held notes a minor third apart, so they all get a voice and keep it
+    for (auto i = 0; i < config.numVoices; ++i)
+        midi.addEvent (juce::MidiMessage::noteOn (1, 36 + 3 * i, (juce::uint8) 100), 0);
+
+    const auto processBlock = [&]
+    {
+        if (config.automationStorm)
+            automationStorm (processor, random);
+
+        processor.processBlock (buffer, midi);
+        midi.clear();
+    };
+
+    const auto numBlocks = [&config] (double seconds) { return (int) std::ceil (seconds * config.sampleRate / config.blockSize); };
+
+    for (auto i = numBlocks (warmUpSeconds); --i >= 0;)
+        processBlock();
+
+    const auto measuredBlocks { numBlocks (measuredSeconds) };
+    const auto start { BenchmarkClock::now() };
+
+    for (auto i = 0; i < measuredBlocks; ++i)
+        processBlock();
+
+    const auto elapsed { secondsSince (start) };
+    const auto numSamples { (double) measuredBlocks * config.blockSize };
+
+    return { elapsed * 1e9 / numSamples, elapsed / (numSamples / config.sampleRate) };
+}
+
+//this takes a few minutes, so it's hidden: run it with `Benchmarks "[throughput]"`
+TEST_CASE ("Throughput matrix", "[.][throughput]")
+{
+    juce::Array<juce::var> results;
+
+    std::cout << "voices  block  sample rate  precision  effect    automation  ns/sample      RTF\n";
+
+    for (const auto numVoices : { 1, 4, 16 })
+        for (const auto blockSize : { 16, 64, 256, 1024, 4096 })
+            for (const auto sampleRate : { 44100., 48000., 96000., 192000. })
+                for (const auto doublePrecision : { false, true })
+                    for (const auto& effect : allEffects)
+                        for (const auto storm : { false, true })
+                        {
+                            const ThroughputConfig config { numVoices, blockSize, sampleRate, doublePrecision, effect, storm };
+                            const auto result { doublePrecision ? measureThroughput<double> (config) : measureThroughput<float> (config) };
+
+                            std::cout << juce::String (numVoices).paddedLeft (' ', 6) << juce::String (blockSize).paddedLeft (' ', 7)
+                                      << juce::String (sampleRate, 0).paddedLeft (' ', 13) << juce::String (doublePrecision ? "double" : "float").paddedLeft (' ', 11)
+                                      << "  " << juce::String (effect.name).paddedRight (' ', 8) << juce::String (storm ? "storm" : "-").paddedLeft (' ', 12)
+                                      << juce::String (result.nsPerSample, 2).paddedLeft (' ', 11) << juce::String (result.realTimeFactor, 5).paddedLeft (' ', 9) << "\n";
+
+                            auto entry { std::make_unique<juce::DynamicObject>() };
+                            entry->setProperty ("voices", numVoices);
+                            entry->setProperty ("blockSize", blockSize);
+                            entry->setProperty ("sampleRate", sampleRate);
+                            entry->setProperty ("precision", doublePrecision ? "double" : "float");
+                            entry->setProperty ("effect", effect.name);
+                            entry->setProperty ("automationStorm", storm);
+                            entry->setProperty ("nsPerSample", result.nsPerSample);
+                            entry->setProperty ("realTimeFactor", result.realTimeFactor);
+                            results.add (juce::var (entry.release()));
+
+                            CHECK (std::isfinite (result.nsPerSample));
+                        }
+
+    const auto file { writeJsonReport ("throughput.json", "throughput", results) };
+    std::cout << "Wrote " << file.getFullPathName() << std::endl;
+}
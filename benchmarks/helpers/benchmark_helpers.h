@@ -0,0 +1,81 @@
+#pragma once
+#include <DSP/ProPhatProcessor.h>
+#include <chrono>
+
+//helpers shared by the benchmarks, which are all included at the end of Catch2Main.cpp
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+[[maybe_unused]] static double secondsSince (BenchmarkClock::time_point start)
+{
+    return std::chrono::duration<double> (BenchmarkClock::now() - start).count();
+}
+
+/** Sets a parameter from its real (i.e. not normalised) value, like a host would. */
+[[maybe_unused]] static void setParameter (ProPhatProcessor& processor, const juce::ParameterID& parameterID, float value)
+{
+    auto* parameter { processor.state.getParameter (parameterID.getParamID()) };
+    jassert (parameter != nullptr);
+    parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+}
+
+/** Every effect we can put in a slot, with each reverb algorithm counting as its own effect. */
+struct EffectConfig
+{
+    const char*             name;
+    EffectType              effect;
+    ReverbAlgorithm::Values reverbAlgorithm;
+};
+
+static const std::array<EffectConfig, 6> allEffects { {
+    { "none", EffectType::none, ReverbAlgorithm::classic },
+    { "PhatVerb", EffectType::verb, ReverbAlgorithm::classic },
+    { "FDN 8", EffectType::verb, ReverbAlgorithm::fdn8 },
+    { "FDN 16", EffectType::verb, ReverbAlgorithm::fdn16 },
+    { "chorus", EffectType::chorus, ReverbAlgorithm::classic },
+    { "phaser", EffectType::phaser, ReverbAlgorithm::classic },
+} };
+
+[[maybe_unused]] static void selectEffect (ProPhatProcessor& processor, const EffectConfig& effect)
+{
+    setParameter (processor, ProPhatParameterIds::effectSelectedID, (float) effect.effect);
+    setParameter (processor, ProPhatParameterIds::reverbAlgorithmID, (float) effect.reverbAlgorithm);
+}
+
+/** Moves a bunch of parameters to random values, like a host playing back dense automation. */
+[[maybe_unused]] static void automationStorm (ProPhatProcessor& processor, juce::Random& random)
+{
+    using namespace ProPhatParameterIds;
+
+    for (const auto& parameterID : { filterCutoffID, filterResonanceID, oscMixID, osc1TuningID, lfoAmountID, lfoFreqID,
+                                     reverbParam1ID, chorusParam1ID, phaserParam1ID, masterGainID })
+        processor.state.getParameter (parameterID.getParamID())->setValueNotifyingHost (random.nextFloat());
+}
+
+/** Benchmarks that write a report put it in PROPHAT_BENCHMARK_OUTPUT_DIR if that's set, and in the
+ *  working directory otherwise.
+ */
+[[maybe_unused]] static juce::File getBenchmarkOutputFile (const juce::String& fileName)
+{
+    const auto outputDir { juce::SystemStats::getEnvironmentVariable ("PROPHAT_BENCHMARK_OUTPUT_DIR", {}) };
+    const auto directory { outputDir.isNotEmpty() ? juce::File (outputDir) : juce::File::getCurrentWorkingDirectory() };
+    [[maybe_unused]] const auto result { directory.createDirectory() };
+
+    return directory.getChildFile (fileName);
+}
+
+/** Writes {"benchmark": name, "buildType": ..., "results": results} to fileName. */
+[[maybe_unused]] static juce::File writeJsonReport (const juce::String& fileName, const juce::String& name, const juce::Array<juce::var>& results)
+{
+    auto report { std::make_unique<juce::DynamicObject>() };
+    report->setProperty ("benchmark", name);
+    report->setProperty ("buildType", CMAKE_BUILD_TYPE);
+    report->setProperty ("date", juce::Time::getCurrentTime().toISO8601 (true));
+    report->setProperty ("results", results);
+
+    const auto file { getBenchmarkOutputFile (fileName) };
+    [[maybe_unused]] const auto success { file.replaceWithText (juce::JSON::toString (juce::var (report.release()))) };
+    jassert (success);
+
+    return file;
+}
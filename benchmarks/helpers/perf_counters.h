@@ -0,0 +1,101 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#if JUCE_LINUX
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+/** Hardware counters around a piece of code, through perf_event_open(). This is Linux only, and opt-in by
+ *  setting PROPHAT_PERF_COUNTERS=1, because it needs a kernel.perf_event_paranoid that allows it and doesn't
+ *  work in most VMs. When the counters can't be opened, isAvailable() returns false and nothing gets measured.
+ */
+class PerfCounters
+{
+public:
+    struct Values
+    {
+        juce::uint64 cycles { 0 };
+        juce::uint64 instructions { 0 };
+        juce::uint64 cacheMisses { 0 };
+        juce::uint64 branchMisses { 0 };
+    };
+
+    PerfCounters()
+    {
+#if JUCE_LINUX
+        if (juce::SystemStats::getEnvironmentVariable ("PROPHAT_PERF_COUNTERS", {}).getIntValue() == 0)
+            return;
+
+        //the first counter leads the group, so they all get started, stopped and read together
+        for (const auto config : { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES })
+        {
+            perf_event_attr attributes {};
+            attributes.type           = PERF_TYPE_HARDWARE;
+            attributes.size           = sizeof (attributes);
+            attributes.config         = config;
+            attributes.disabled       = fds.empty() ? 1 : 0;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv     = 1;
+            attributes.read_format    = PERF_FORMAT_GROUP;
+
+            const auto fd { (int) syscall (SYS_perf_event_open, &attributes, 0, -1, fds.empty() ? -1 : fds.front(), 0) };
+            if (fd < 0)
+            {
+                closeAll();
+                return;
+            }
+
+            fds.push_back (fd);
+        }
+#endif
+    }
+
+    ~PerfCounters() { closeAll(); }
+
+    bool isAvailable() const { return ! fds.empty(); }
+
+    void start()
+    {
+#if JUCE_LINUX
+        if (! isAvailable())
+            return;
+
+        ioctl (fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl (fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    Values stop()
+    {
+        Values values;
+#if JUCE_LINUX
+        if (! isAvailable())
+            return values;
+
+        ioctl (fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        //with PERF_FORMAT_GROUP we read the number of counters, followed by their values
+        std::array<juce::uint64, 5> data {};
+        if (read (fds.front(), data.data(), sizeof (data)) > 0 && data[0] == 4)
+            values = { data[1], data[2], data[3], data[4] };
+#endif
+        return values;
+    }
+
+private:
+    void closeAll()
+    {
+#if JUCE_LINUX
+        for (const auto fd : fds)
+            close (fd);
+#endif
+        fds.clear();
+    }
+
+    std::vector<int> fds;
+
+    JUCE_DECLARE_NON_COPYABLE (PerfCounters)
+};
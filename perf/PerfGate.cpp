@@ -0,0 +1,202 @@
+// The performance regression gate. Each scenario is timed relative to a fixed calibration workload, so that
+// the baseline in perf/baseline.json roughly carries over between machines, and the gate fails when a scenario
+// got slower than the baseline by more than the tolerance.
+//
+// Run `PerfGate --update-baseline` on a quiet machine to (re)write the baseline after an intended change.
+// A missing baseline file, or a scenario missing from it, fails the gate. That's why it isn't a ctest: CI runs
+// it in its own step, and only once perf/baseline.json has scenarios recorded on the CI runner.
+
+#include "../benchmarks/helpers/benchmark_helpers.h"
+#include "juce_gui_basics/juce_gui_basics.h"
+#include <catch2/catch_session.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+static bool shouldUpdateBaseline { false };
+
+//keeps the calibration loop from being optimised away
+static volatile float calibrationSink { 0.f };
+
+namespace PerfGate
+{
+constexpr auto defaultTolerance { .25 };
+constexpr auto numRepetitions { 7 };
+constexpr auto sampleRate { 48000. };
+constexpr auto blockSize { 512 };
+
+/** The fastest of numRepetitions runs, which is the one the rest of the machine disturbed the least. */
+template <typename Workload>
+static double measureMinSeconds (Workload&& workload)
+{
+    auto best { std::numeric_limits<double>::max() };
+    for (auto i = 0; i < numRepetitions; ++i)
+    {
+        const auto start { BenchmarkClock::now() };
+        workload();
+        best = std::min (best, secondsSince (start));
+    }
+
+    return best;
+}
+
+/** A workload that doesn't depend on our code: a chain of one pole filters, which is the kind of serial
+ *  floating point work our dsp does.
+ */
+static double measureCalibration()
+{
+    std::vector<float> buffer (4096, 1.f);
+
+    return measureMinSeconds ([&buffer]
+    {
+        auto state { 0.f };
+        for (auto pass = 0; pass < 500; ++pass)
+            for (auto& sample : buffer)
+            {
+                state  = state * .99f + sample * .01f;
+                sample = state - sample * .5f;
+            }
+
+        calibrationSink = buffer.front();
+    });
+}
+
+struct Scenario
+{
+    const char*         name;
+    int                 numVoices;
+    bool                doublePrecision;
+    const EffectConfig& effect;
+    bool                automationStorm;
+};
+
+template <std::floating_point T>
+static double measureScenario (const Scenario& scenario)
+{
+    constexpr auto numBlocks { 200 };
+
+    ProPhatProcessor processor;
+    selectEffect (processor, scenario.effect);
+    processor.setProcessingPrecision (std::is_same_v<T, double> ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    juce::AudioBuffer<T> buffer (2, blockSize);
+    juce::MidiBuffer     midi;
+    juce::Random         random (1234);
+
+    for (auto i = 0; i < scenario.numVoices; ++i)
+        midi.addEvent (juce::MidiMessage::noteOn (1, 36 + 3 * i, (juce::uint8) 100), 0);
+
+    //the first run also gets us through the attacks and the effect crossfade
+    return measureMinSeconds ([&]
+    {
+        for (auto i = 0; i < numBlocks; ++i)
+        {
+            if (scenario.automationStorm)
+                automationStorm (processor, random);
+
+            processor.processBlock (buffer, midi);
+            midi.clear();
+        }
+    });
+}
+
+static double getTolerance (const juce::var& baseline)
+{
+    if (const auto fromEnvironment { juce::SystemStats::getEnvironmentVariable ("PROPHAT_PERF_TOLERANCE", {}) }; fromEnvironment.isNotEmpty())
+        return fromEnvironment.getDoubleValue();
+
+    if (baseline.hasProperty ("tolerance"))
+        return (double) baseline["tolerance"];
+
+    return defaultTolerance;
+}
+
+static juce::File getBaselineFile() { return juce::File (PERF_BASELINE_FILE); }
+} // namespace PerfGate
+
+TEST_CASE ("Performance regression gate", "[perf]")
+{
+    using namespace PerfGate;
+
+    const std::array<Scenario, 8> scenarios { {
+        { "idle", 0, false, allEffects[0], false },
+        { "16 voices, no effect", 16, false, allEffects[0], false },
+        { "16 voices, PhatVerb", 16, false, allEffects[1], false },
+        { "16 voices, PhatVerb, double", 16, true, allEffects[1], false },
+        { "16 voices, FDN 16", 16, false, allEffects[3], false },
+        { "16 voices, chorus", 16, false, allEffects[4], false },
+        { "16 voices, phaser", 16, false, allEffects[5], false },
+        { "16 voices, PhatVerb, automation storm", 16, false, allEffects[1], true },
+    } };
+
+    const auto baselineFile { getBaselineFile() };
+    const auto baseline { juce::JSON::parse (baselineFile) };
+
+    //without a baseline the gate can't gate anything, so that's a failure unless we're recording one
+    if (! shouldUpdateBaseline && ! baseline["scenarios"].isObject())
+        FAIL ("No baseline in " << baselineFile.getFullPathName() << ", record one with PerfGate --update-baseline");
+    const auto tolerance { getTolerance (baseline) };
+    const auto calibrationSeconds { measureCalibration() };
+
+    auto newScenarios { std::make_unique<juce::DynamicObject>() };
+
+    std::cout << "calibration: " << calibrationSeconds * 1000. << " ms, tolerance: " << tolerance * 100. << "%\n";
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto seconds { scenario.doublePrecision ? measureScenario<double> (scenario) : measureScenario<float> (scenario) };
+        const auto ratio { seconds / calibrationSeconds };
+        newScenarios->setProperty (scenario.name, ratio);
+
+        const auto baselineRatio { baseline["scenarios"][scenario.name] };
+        std::cout << juce::String (scenario.name).paddedRight (' ', 40) << juce::String (ratio, 4).paddedLeft (' ', 10);
+
+        if (shouldUpdateBaseline)
+        {
+            std::cout << "\n";
+            continue;
+        }
+
+        //a scenario that was added or renamed since the baseline was recorded needs a new baseline
+        if (baselineRatio.isVoid() || (double) baselineRatio <= 0.)
+        {
+            std::cout << "  (no baseline)\n";
+            ADD_FAIL (scenario.name << " has no baseline in " << baselineFile.getFullPathName() << ", record one with PerfGate --update-baseline");
+            continue;
+        }
+
+        const auto change { ratio / (double) baselineRatio - 1. };
+        std::cout << "  baseline " << juce::String ((double) baselineRatio, 4) << ", " << (change >= 0 ? "+" : "") << juce::String (change * 100., 1) << "%\n";
+
+        INFO (scenario.name << " went from " << (double) baselineRatio << " to " << ratio << " times the calibration time");
+        CHECK (change <= tolerance);
+    }
+
+    if (shouldUpdateBaseline)
+    {
+        auto newBaseline { std::make_unique<juce::DynamicObject>() };
+        newBaseline->setProperty ("tolerance", tolerance);
+        newBaseline->setProperty ("machine", juce::SystemStats::getCpuModel());
+        newBaseline->setProperty ("buildType", CMAKE_BUILD_TYPE);
+        newBaseline->setProperty ("date", juce::Time::getCurrentTime().toISO8601 (true));
+        newBaseline->setProperty ("scenarios", juce::var (newScenarios.release()));
+
+        REQUIRE (baselineFile.replaceWithText (juce::JSON::toString (juce::var (newBaseline.release()))));
+        std::cout << "Updated " << baselineFile.getFullPathName() << std::endl;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    //the processor's state needs a message manager
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    Catch::Session session;
+
+    using namespace Catch::Clara;
+    session.cli (session.cli() | Opt (shouldUpdateBaseline)["--update-baseline"]("rewrite perf/baseline.json with the timings of this run"));
+
+    if (const auto result { session.applyCommandLine (argc, argv) }; result != 0)
+        return result;
+
+    return session.run();
+}
@@ -24,6 +24,11 @@
 #include "../Utility/Helpers.h"
 #include <random>
 
+/**
+ * @brief A gained oscillator with a single phase accumulator shared by all its shapes.
+    Owning the phase (instead of using one juce::dsp::Oscillator per shape) means the phase is
+    continuous when switching shapes, and it lets us derive a phase-locked sub octave from it.
+*/
 template <std::floating_point T>
 class GainedOscillator
 {
@@ -32,29 +37,29 @@ public:
         distribution ((T) -1, (T) 1)
     {
         //TODO: I should compare these waves on the scope with the waves from the prophet
-        oscs[OscShape::none].initialise ([] (T /*x*/) { return T (0); });
-        oscs[OscShape::saw].initialise  ([] (T x) { return juce::jmap (x, T (-juce::MathConstants<T>::pi), T (juce::MathConstants<T>::pi), T (-1), T (1)); }, 2);
-
-        oscs[OscShape::sawTri].initialise ([] (T x)
-                                           {
-                                               T y = juce::jmap (x, T (-juce::MathConstants<T>::pi), T (juce::MathConstants<T>::pi), T (-1), T (1)) / 2;
-
-                                               if (x < 0)
-                                                   return y += juce::jmap (x, T (-juce::MathConstants<T>::pi), T (0), T (-1), T (1)) / 2;
-                                               else
-                                                   return y += juce::jmap (x, T (0), T (juce::MathConstants<T>::pi), T (1), T (-1)) / 2;
-                                           }, 128);
-
-        oscs[OscShape::triangle].initialise ([] (T x)
-                                             {
-                                                 if (x < 0)
-                                                     return juce::jmap (x, T (-juce::MathConstants<T>::pi), T (0), T (-1), T (1));
-                                                 else
-                                                     return juce::jmap (x, T (0), T (juce::MathConstants<T>::pi), T (1), T (-1));
-                                             }, 128);
-
-        oscs[OscShape::pulse].initialise ([] (T x) { if (x < 0) return T (-1); else return T (1); }, 16);
-        oscs[OscShape::noise].initialise ([this] (T /*x*/) { return distribution (generator); });
+        initialise (OscShape::none, [] (T /*x*/) { return T (0); });
+        initialise (OscShape::saw,  [] (T x) { return juce::jmap (x, T (-juce::MathConstants<T>::pi), T (juce::MathConstants<T>::pi), T (-1), T (1)); }, 2);
+
+        initialise (OscShape::sawTri, [] (T x)
+                                      {
+                                          T y = juce::jmap (x, T (-juce::MathConstants<T>::pi), T (juce::MathConstants<T>::pi), T (-1), T (1)) / 2;
+
+                                          if (x < 0)
+                                              return y += juce::jmap (x, T (-juce::MathConstants<T>::pi), T (0), T (-1), T (1)) / 2;
+                                          else
+                                              return y += juce::jmap (x, T (0), T (juce::MathConstants<T>::pi), T (1), T (-1)) / 2;
+                                      }, 128);
+
+        initialise (OscShape::triangle, [] (T x)
+                                        {
+                                            if (x < 0)
+                                                return juce::jmap (x, T (-juce::MathConstants<T>::pi), T (0), T (-1), T (1));
+                                            else
+                                                return juce::jmap (x, T (0), T (juce::MathConstants<T>::pi), T (1), T (-1));
+                                        }, 128);
+
+        initialise (OscShape::pulse, [] (T x) { if (x < 0) return T (-1); else return T (1); }, 16);
+        initialise (OscShape::noise, [this] (T /*x*/) { return distribution (generator); });
 
         setOscShape (OscShape::saw);
         setGain (Constants::defaultOscLevel);
@@ -64,15 +69,18 @@ public:
     {
         jassert (newValue > 0);
 
-        curOsc.load()->setFrequency (newValue, force);
+        if (force)
+            frequency.setCurrentAndTargetValue (newValue);
+        else
+            frequency.setTargetValue (newValue);
     }
 
     void setOscShape (OscShape::Values newShape)
     {
         //TODO: AFAICT we never get in here so probably useless?
         // Early-out if the requested shape is already selected.
-        auto* currentPtr = curOsc.load();
-        auto* requestedPtr = &oscs[static_cast<std::size_t> (newShape)];
+        auto* currentPtr = curGenerator.load();
+        auto* requestedPtr = &generators[static_cast<std::size_t> (newShape)];
         if (currentPtr == requestedPtr)
             return;
 
@@ -85,21 +93,28 @@ public:
 
         switch (newShape)
         {
-            case OscShape::none:     curOsc.store (&oscs[OscShape::none]);      break;
-            case OscShape::saw:      curOsc.store (&oscs[OscShape::saw]);       break;
-            case OscShape::sawTri:   curOsc.store (&oscs[OscShape::sawTri]);    break;
-            case OscShape::triangle: curOsc.store (&oscs[OscShape::triangle]);  break;
-            case OscShape::pulse:    curOsc.store (&oscs[OscShape::pulse]);     break;
-            case OscShape::noise:    curOsc.store (&oscs[OscShape::noise]);     break;
+            case OscShape::none:     curGenerator.store (&generators[OscShape::none]);      break;
+            case OscShape::saw:      curGenerator.store (&generators[OscShape::saw]);       break;
+            case OscShape::sawTri:   curGenerator.store (&generators[OscShape::sawTri]);    break;
+            case OscShape::triangle: curGenerator.store (&generators[OscShape::triangle]);  break;
+            case OscShape::pulse:    curGenerator.store (&generators[OscShape::pulse]);     break;
+            case OscShape::noise:    curGenerator.store (&generators[OscShape::noise]);     break;
             default: jassertfalse;
         }
 
+        //the sub gets muted with the oscillator, like it was when it went through our gain
         if (wasActive != isActive)
         {
             if (isActive)
+            {
                 setGain (lastActiveGain);
+                setSubOctaveGain (lastActiveSubOctaveGain);
+            }
             else
+            {
                 setGain (0);
+                setSubOctaveGain (0);
+            }
         }
     }
 
@@ -121,31 +136,150 @@ public:
 
     T getGain () { return lastActiveGain; }
 
+    /**
+     * @brief Sets the level of the square sub octave. The sub is generated from this oscillator's own phase
+        accumulator by flipping its polarity every time the phase wraps (i.e., a divide-by-two flip-flop), so it is
+        always exactly one octave down and phase-locked to this oscillator, like on the rev2. A level of 0 disables it.
+        The sub is muted when the shape is none, like the main wave, but it isn't affected by setGain(), so any
+        scaling (velocity, osc mix) has to be folded into newGain by the caller.
+        This can be called from any thread; process() picks the new level up and ramps to it.
+    */
+    void setSubOctaveGain (T newGain)
+    {
+        if (! isActive)
+            newGain = 0;
+        else
+            lastActiveSubOctaveGain = newGain;
+
+        subOctaveTarget = newGain;
+    }
+
     void reset () noexcept
     {
-        curOsc.load ()->reset();
+        phase.reset();
+        frequency.reset (sampleRate, frequencyRampSeconds);
+        subPolarity = T (1);
+        subOctaveGain.reset (sampleRate, subOctaveRampSeconds);
+        subOctaveGain.setCurrentAndTargetValue (subOctaveTarget.load());
         gain.reset();
     }
 
+    /** Adds the oscillator (and its sub octave, if any) to the content of the context's output block. */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
     {
-        curOsc.load ()->process (context);
-        gain.process (context);
+        auto&& outBlock       = context.getOutputBlock();
+        const auto numSamples = outBlock.getNumSamples();
+        const auto numChannels = outBlock.getNumChannels();
+        jassert (context.getInputBlock().getNumSamples() == numSamples);
+
+        subOctaveGain.setTargetValue (subOctaveTarget.load());
+
+        const auto& generatorFn  = *curGenerator.load();
+        const auto  isNoise      = &generatorFn == &generators[OscShape::noise];
+        const auto  hasSubOctave = subOctaveGain.isSmoothing() || subOctaveGain.getTargetValue() > T (0);
+        const auto  twoPiOverSr  = juce::MathConstants<T>::twoPi / static_cast<T> (sampleRate);
+
+        auto increment = frequency.getNextValue() * twoPiOverSr;
+        const auto isSmoothing = frequency.isSmoothing();
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            if (isSmoothing && i > 0)
+                increment = frequency.getNextValue() * twoPiOverSr;
+
+            //x is the phase for this sample; after advancing, phase.phase is the phase for the next one
+            const auto x       = phase.advance (increment);
+            const auto curGain = gain.processSample (T (1));
+            const auto sub     = hasSubOctave ? subOctaveGain.getNextValue() * getSubOctaveSample (x, increment) : T (0);
+
+            //divide by two: flip the sub every time we wrap. We keep counting even when the sub is off,
+            //so that it comes back locked to our phase
+            if (phase.phase < x)
+                subPolarity = -subPolarity;
+
+            //juce::dsp::Oscillator called its generator once per channel, which is what made the noise stereo,
+            //so keep drawing one noise sample per channel. The periodic shapes are the same on every channel.
+            if (isNoise)
+            {
+                for (size_t c = 0; c < numChannels; ++c)
+                    outBlock.getChannelPointer (c)[i] += curGain * generatorFn (x - juce::MathConstants<T>::pi) + sub;
+            }
+            else
+            {
+                const auto sample = curGain * generatorFn (x - juce::MathConstants<T>::pi) + sub;
+
+                for (size_t c = 0; c < numChannels; ++c)
+                    outBlock.getChannelPointer (c)[i] += sample;
+            }
+        }
     }
 
     void prepare (const juce::dsp::ProcessSpec& spec)
     {
-        for (auto& osc : oscs)
-            osc.prepare (spec);
+        sampleRate = spec.sampleRate;
+        reset();
 
         gain.prepare (spec);
     }
 
 private:
+    void initialise (OscShape::Values shape, const std::function<T (T)>& function, size_t lookupTableNumPoints = 0)
+    {
+        //this is the same thing juce::dsp::Oscillator::initialise() does
+        auto& shapeGenerator = generators[static_cast<std::size_t> (shape)];
+
+        if (lookupTableNumPoints != 0)
+        {
+            auto& table = lookupTables[static_cast<std::size_t> (shape)];
+            table = std::make_unique<juce::dsp::LookupTableTransform<T>> (function, -juce::MathConstants<T>::pi, juce::MathConstants<T>::pi, lookupTableNumPoints);
+            shapeGenerator = [t = table.get()] (T x) { return (*t) (x); };
+        }
+        else
+        {
+            shapeGenerator = function;
+        }
+    }
+
+    /** A naive square at half our frequency, with a polyBLEP on the edges, which happen when our phase wraps. */
+    T getSubOctaveSample (T curPhase, T increment) const noexcept
+    {
+        const auto t  = curPhase / juce::MathConstants<T>::twoPi;
+        const auto dt = increment / juce::MathConstants<T>::twoPi;
+
+        //we just wrapped, so the polarity already flipped
+        if (t < dt)
+        {
+            const auto n = t / dt;
+            return subPolarity * (T (1) + (n + n - n * n - T (1)));
+        }
+
+        //we're about to wrap, so the polarity is about to flip
+        if (t > T (1) - dt)
+        {
+            const auto n = (t - T (1)) / dt;
+            return subPolarity - subPolarity * (n * n + n + n + T (1));
+        }
+
+        return subPolarity;
+    }
+
+    static constexpr auto frequencyRampSeconds { 0.05 };
+    static constexpr auto subOctaveRampSeconds { 0.05 };
+
+    std::array<std::function<T (T)>, OscShape::actualTotal> generators;
+    std::array<std::unique_ptr<juce::dsp::LookupTableTransform<T>>, OscShape::actualTotal> lookupTables;
+    std::atomic<std::function<T (T)>*> curGenerator { nullptr };
+
+    juce::dsp::Phase<T>    phase;
+    juce::SmoothedValue<T> frequency { T (440) };
+    double                 sampleRate { 44100.0 };
 
-    std::array<juce::dsp::Oscillator<T>, OscShape::actualTotal> oscs;
-    std::atomic<juce::dsp::Oscillator<T>*> curOsc { nullptr };
+    //the target is written by the parameter thread, and the smoother is only touched by the audio thread
+    std::atomic<T>         subOctaveTarget {};
+    juce::SmoothedValue<T> subOctaveGain;
+    T                      lastActiveSubOctaveGain {};
+    T                      subPolarity { 1 };
 
     bool isActive = true;
 
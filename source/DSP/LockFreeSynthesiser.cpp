@@ -257,6 +257,19 @@ void LockFreeSynthesiser::noteOn (const int midiChannel, const int midiNoteNumbe
     {
         if (sound->appliesToNote (midiNoteNumber) && sound->appliesToChannel (midiChannel))
         {
+            // If recycling voices, hitting a note that's still ringing simply retriggers it
+            if (shouldRecycleVoices.load())
+            {
+                auto retriggered = false;
+
+                for (auto* voice : voices)
+                    if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel (midiChannel))
+                        retriggered = retriggerVoice (voice, sound, midiChannel, midiNoteNumber, velocity) || retriggered;
+
+                if (retriggered)
+                    continue;
+            }
+
             // If hitting a note that's still ringing, stop it first (it could be
             // still playing because of the sustain or sostenuto pedal).
             for (auto* voice : voices)
@@ -272,14 +285,17 @@ void LockFreeSynthesiser::noteOn (const int midiChannel, const int midiNoteNumbe
     }
 }
 
-void LockFreeSynthesiser::startVoice (LockFreeSynthesiserVoice* const voice,
-                                      juce::SynthesiserSound* const   sound,
-                                      const int                       midiChannel,
-                                      const int                       midiNoteNumber,
-                                      const float                     velocity)
+void LockFreeSynthesiser::startVoice (LockFreeSynthesiserVoice*     voice,
+                                      juce::SynthesiserSound* const sound,
+                                      const int                     midiChannel,
+                                      const int                     midiNoteNumber,
+                                      const float                   velocity)
 {
     if (voice != nullptr && sound != nullptr)
     {
+        if (voice->currentlyPlayingSound != nullptr)
+            voice = handOffStolenVoice (voice);
+
         if (voice->currentlyPlayingSound != nullptr)
             voice->stopNote (0.0f, false);
 
@@ -295,6 +311,25 @@ void LockFreeSynthesiser::startVoice (LockFreeSynthesiserVoice* const voice,
     }
 }
 
+bool LockFreeSynthesiser::retriggerVoice (LockFreeSynthesiserVoice* const voice,
+                                          juce::SynthesiserSound* const   sound,
+                                          const int                       midiChannel,
+                                          const int                       midiNoteNumber,
+                                          const float                     velocity)
+{
+    jassert (voice != nullptr && voice->getCurrentlyPlayingNote() == midiNoteNumber);
+
+    if (! voice->retriggerNote (midiNoteNumber, velocity, sound, lastPitchWheelValues[midiChannel - 1]))
+        return false;
+
+    voice->noteOnTime = ++lastNoteOnCounter;
+    voice->setKeyDown (true);
+    voice->setSostenutoPedalDown (false);
+    voice->setSustainPedalDown (sustainPedalsDown[midiChannel]);
+
+    return true;
+}
+
 void LockFreeSynthesiser::noteOff (const int midiChannel, const int midiNoteNumber, const float velocity, const bool allowTailOff)
 {
     for (auto* voice : voices)
@@ -94,6 +94,17 @@ class LockFreeSynthesiserVoice
     */
     virtual void stopNote (float velocity, bool allowTailOff) = 0;
 
+    /** Called instead of stopNote() and startNote() when the note that this voice is playing is hit again,
+        and voice recycling is enabled in the synth.
+
+        The voice should restart its envelopes from wherever they currently are, and keep everything else
+        (oscillator phases, filter state, etc.) continuous. Return false if the voice can't do that, in which
+        case the synth will stop it and start the note on another voice, like it does when recycling is disabled.
+
+        This will be called during the rendering callback, so must be fast and thread-safe.
+    */
+    virtual bool retriggerNote (int /*midiNoteNumber*/, float /*velocity*/, juce::SynthesiserSound* /*sound*/, int /*currentPitchWheelPosition*/) { return false; }
+
     /** Returns true if this voice is currently busy playing a sound.
         By default, this just checks the getCurrentlyPlayingNote() value, but can
         be overridden for more advanced checking.
@@ -267,6 +278,16 @@ class LockFreeSynthesiser
     */
     [[nodiscard]] bool isNoteStealingEnabled() const noexcept { return shouldStealNotes; }
 
+    /** If set to true, hitting a note that is still ringing on a voice will retrigger that same voice
+        (see LockFreeSynthesiserVoice::retriggerNote()) instead of stopping it and starting another one.
+    */
+    void setVoiceRecyclingEnabled (bool shouldRecycle) noexcept { shouldRecycleVoices = shouldRecycle; }
+
+    /** Returns true if voice recycling is enabled.
+        @see setVoiceRecyclingEnabled
+    */
+    [[nodiscard]] bool isVoiceRecyclingEnabled() const noexcept { return shouldRecycleVoices; }
+
     //==============================================================================
     /** Triggers a note-on event.
 
@@ -499,6 +520,14 @@ class LockFreeSynthesiser
                                                         int                     midiChannel,
                                                         int                     midiNoteNumber) const;
 
+    /** Called by startVoice() when the voice it was given is still playing something, i.e. it is being stolen.
+
+        You can return a different, free voice to start the new note on instead, which lets the stolen voice
+        fade out on its own over the next render calls. The default returns the same voice, which then gets
+        stopped with stopNote (0, false) before the new note starts on it.
+    */
+    virtual LockFreeSynthesiserVoice* handOffStolenVoice (LockFreeSynthesiserVoice* stolenVoice) { return stolenVoice; }
+
     /** Starts a specified voice playing a particular sound.
         You'll probably never need to call this, it's used internally by noteOn(), but
         may be needed by subclasses for custom behaviours.
@@ -509,6 +538,15 @@ class LockFreeSynthesiser
                      int                       midiNoteNumber,
                      float                     velocity);
 
+    /** Retriggers a voice that is already playing midiNoteNumber, see setVoiceRecyclingEnabled().
+        Returns false if the voice couldn't be retriggered.
+    */
+    bool retriggerVoice (LockFreeSynthesiserVoice* voice,
+                         juce::SynthesiserSound*   sound,
+                         int                       midiChannel,
+                         int                       midiNoteNumber,
+                         float                     velocity);
+
     /** Can be overridden to do custom handling of incoming midi events. */
     virtual void handleMidiEvent (const juce::MidiMessage&);
 
@@ -519,6 +557,7 @@ class LockFreeSynthesiser
     int                                            minimumSubBlockSize         = 32;
     bool                                           subBlockSubdivisionIsStrict = false;
     bool                                           shouldStealNotes            = true;
+    std::atomic<bool>                              shouldRecycleVoices         { false };
     juce::BigInteger                               sustainPedalsDown;
     mutable juce::Array<LockFreeSynthesiserVoice*> usableVoicesToStealArray;
 
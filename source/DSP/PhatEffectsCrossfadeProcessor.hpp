@@ -23,7 +23,6 @@
 #pragma once
 
 #include "../Utility/Helpers.h"
-#include "../modules/DebugLog/Source/DebugLog.hpp"
 #include <sstream>
 
 constexpr auto crossfadeDurationSeconds = .1;
@@ -69,78 +68,73 @@ class EffectsCrossfadeProcessor
     void prepare (const juce::dsp::ProcessSpec& spec)
     {
         jassert (spec.numChannels == 2);
-        smoothedGainL.reset (spec.sampleRate, static_cast<T> (crossfadeDurationSeconds));
-        smoothedGainR.reset (spec.sampleRate, static_cast<T> (crossfadeDurationSeconds));
+        smoothedGain.reset (spec.sampleRate, static_cast<T> (crossfadeDurationSeconds));
+
+        gainRamp.allocate (spec.maximumBlockSize, true);
+        maxRampSamples = (int) spec.maximumBlockSize;
     }
 
+    /** Starts a crossfade from the current effect to this one. Only call this from the audio thread, and only
+        once the previous crossfade is done.
+    */
     void changeEffect (EffectType effect)
     {
-        //first reverse the smoothedGain. If we're not at one of the extremes, we got a double click which we'll ignore
-        jassert (juce::approximatelyEqual (smoothedGainL.getTargetValue(), static_cast<T> (1))
-                 || juce::approximatelyEqual (smoothedGainL.getTargetValue(), static_cast<T> (0)));
-        if (juce::approximatelyEqual (smoothedGainL.getTargetValue(), static_cast<T> (1)))
-        {
-            smoothedGainL.setTargetValue (0.);
-            smoothedGainR.setTargetValue (0.);
-        }
-        else
-        {
-            smoothedGainL.setTargetValue (1.);
-            smoothedGainR.setTargetValue (1.);
-        }
+        jassert (! smoothedGain.isSmoothing());
+
+        //the previous effect's gain goes from 1 to 0 whichever way smoothedGain goes, so we just flip it
+        smoothedGain.setTargetValue (juce::approximatelyEqual (smoothedGain.getTargetValue(), static_cast<T> (1)) ? 0 : 1);
 
         prevEffect = curEffect;
         curEffect  = effect;
     }
 
-    EffectType getCurrentEffectType() const
+    /** Turns the current crossfade around, so we go back to the previous effect from wherever we are. */
+    void reverse()
     {
-        //TODO: this isn't atomic. Try lock?
-        if (smoothedGainL.isSmoothing())
-            return EffectType::transitioning;
+        jassert (smoothedGain.isSmoothing());
 
-        return curEffect;
+        //the previous effect's gain is g when heading for 0 and 1 - g when heading for 1, so flipping the
+        //target and swapping the effects gives both of them the same gain as they had
+        smoothedGain.setTargetValue (static_cast<T> (1) - smoothedGain.getTargetValue());
+        std::swap (prevEffect, curEffect);
     }
 
-#if ENABLE_DEBUG_LOG
-    void setDebugLogEntry (DebugLogEntry* _debugLogEntry)
+    /** Audio thread only. */
+    EffectType getCurrentEffectType() const
     {
-        debugLogEntry = _debugLogEntry;
+        if (smoothedGain.isSmoothing())
+            return EffectType::transitioning;
+
+        return curEffect;
     }
-#endif
 
-    void process (const juce::AudioBuffer<T>&                  previousEffectBuffer,
-                  const juce::AudioBuffer<T>&                  nextEffectBuffer,
-                  const juce::dsp::ProcessContextReplacing<T>& context)
+    /** Crossfades from the previous effect to the next one. The next effect has already been processed in place
+        in the context, and the previous one in previousEffectBuffer, which we use as scratch space here.
+    */
+    void process (juce::AudioBuffer<T>& previousEffectBuffer, const juce::dsp::ProcessContextReplacing<T>& context)
     {
-        const auto& inputBlock { context.getInputBlock() };
-        jassert ((int) previousEffectBuffer.getNumChannels() >= nextEffectBuffer.getNumChannels()
-                 && (int) nextEffectBuffer.getNumChannels() >= inputBlock.getNumChannels());
-        jassert ((int) previousEffectBuffer.getNumSamples() >= nextEffectBuffer.getNumSamples()
-                 && (int) nextEffectBuffer.getNumSamples() >= inputBlock.getNumSamples());
-
-        const bool needToInverse = juce::approximatelyEqual (smoothedGainL.getTargetValue (), static_cast<T> (1));
+        auto&      outputBlock { context.getOutputBlock() };
+        const auto numSamples { (int) outputBlock.getNumSamples() };
+        jassert (previousEffectBuffer.getNumChannels() >= (int) outputBlock.getNumChannels());
+        jassert (previousEffectBuffer.getNumSamples() >= numSamples && maxRampSamples >= numSamples);
+
+        //the gain of the previous effect goes from 1 to 0 whichever way smoothedGain goes, and that ramp
+        //is the same for all channels, so we only compute it once
+        const bool needToInverse = juce::approximatelyEqual (smoothedGain.getTargetValue (), static_cast<T> (1));
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const auto nextGain = smoothedGain.getNextValue();
+            gainRamp[sample]    = needToInverse ? (T { 1 } - nextGain) : nextGain;
+        }
 
-        T curGain {};
-        for (int channel = 0; channel < (int) inputBlock.getNumChannels (); ++channel)
+        //out = next * (1 - gain) + prev * gain = next + (prev - next) * gain
+        for (int channel = 0; channel < (int) outputBlock.getNumChannels (); ++channel)
         {
-            const auto* prevData = previousEffectBuffer.getReadPointer (channel);
-            const auto* nextData = nextEffectBuffer.getReadPointer (channel);
-            auto*       outData  = context.getOutputBlock().getChannelPointer (channel);
-
-            for (int sample = 0; sample < (int) inputBlock.getNumSamples(); ++sample)
-            {
-                jassert (channel == 0 || channel == 1);
-                auto nextGain = (channel == 0) ? smoothedGainL.getNextValue() : smoothedGainR.getNextValue();
-                curGain = needToInverse ? (T{1} - nextGain) : nextGain;
-
-                outData[sample] = prevData[sample] * curGain + nextData[sample] * (1 - curGain);
-
-#if ENABLE_DEBUG_LOG
-                if (debugLogEntry && channel == 0 && sample == 0)
-                    debugLogEntry->firstGain = static_cast<float> (outData[sample]);
-#endif
-            }
+            auto* prevData = previousEffectBuffer.getWritePointer (channel);
+            auto* outData  = outputBlock.getChannelPointer (channel);
+
+            juce::FloatVectorOperations::subtract (prevData, outData, numSamples);
+            juce::FloatVectorOperations::addWithMultiply (outData, prevData, gainRamp.getData(), numSamples);
         }
     }
 
@@ -148,9 +142,9 @@ class EffectsCrossfadeProcessor
     EffectType curEffect  = EffectType::verb;
 
   private:
-    juce::SmoothedValue<T, juce::ValueSmoothingTypes::Linear> smoothedGainL;
-    juce::SmoothedValue<T, juce::ValueSmoothingTypes::Linear> smoothedGainR;
-#if ENABLE_DEBUG_LOG
-    DebugLogEntry* debugLogEntry { nullptr };
-#endif
+    juce::SmoothedValue<T, juce::ValueSmoothingTypes::Linear> smoothedGain;
+
+    //the previous effect's gain for the current block
+    juce::HeapBlock<T> gainRamp;
+    int                maxRampSamples { 0 };
 };
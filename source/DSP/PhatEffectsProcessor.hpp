@@ -22,70 +22,55 @@
 
 #pragma once
 
-#include "../modules/DebugLog/Source/DebugLog.hpp"
+#include "../Utility/TraceLog.h"
 #include "PhatEffectsCrossfadeProcessor.hpp"
+#include "PhatFdnVerb.h"
 #include "PhatVerb.h"
 
-//TODO VB: so as of 2025-10-20, having this on or off does not make more or less clicks, but if you have it off, and have a
-//note finish with reverb on, then toggle reverb off, and back on (after the note is done, with no release), then the reverb
-//will still output a trail because it hasn't been cleared. However it's cleared at every buffer now -- we could probably
-//just clear it once we've transitioned out of a given effect
-#define ENABLE_CLEAR_EFFECT 1
 #define LOG_EVERYTHING_AFTER_TRANSITION 0
 
+/** One slot of the effect chain. It holds an instance of every effect, runs the selected one and crossfades
+    whenever the selection changes or the slot gets bypassed, then blends the result with the dry input.
+*/
 template <std::floating_point T>
-class EffectsProcessor
+class EffectSlot
 {
   public:
-    EffectsProcessor()
+    EffectSlot (EffectType initialEffect, int index = 0)
+    : slotIndex (index)
+    , selectedEffect (initialEffect)
     {
-#if ENABLE_DEBUG_LOG
-        //TODO: presumably this can be DRYed into some function and called from the main processor
-        DebugLog tempData;
-        memset (&tempData, 0, sizeof (tempData));
-
-        // Initialize the file that will receive the log
-        if (! memoryMappedFile.existsAsFile() || memoryMappedFile.getSize() != sizeof (DebugLog))
-        {
-            bool success = memoryMappedFile.deleteFile(); // Start clean if it already exists
-            success      = memoryMappedFile.replaceWithData (&tempData, sizeof (tempData));
-            jassert (success); // Fail loudly if replaceWithData failed
-        }
-        jassert (memoryMappedFile.getSize() == sizeof (DebugLog)); // Confirm correct size
-
-        // Create the memory mapped file
-        m_pLogDebugMapping = std::make_unique<juce::MemoryMappedFile> (memoryMappedFile, juce::MemoryMappedFile::readWrite, false);
-        jassert (m_pLogDebugMapping != nullptr);
-
-        m_pLogDebug = static_cast<DebugLog*> (m_pLogDebugMapping->getData());
-        if (m_pLogDebug)
-        {
-            m_pLogDebug->logHead = 0;
-            memset (m_pLogDebug->log, 0, sizeof (m_pLogDebug->log));
-        }
-        else
-        {
-            jassertfalse; // Failed to map the log memory!
-        }
-#endif
+        effectCrossFader.curEffect = initialEffect;
 
         verbWrapper = std::make_unique<EffectProcessorWrapper<PhatVerbProcessor<T>, T>>();
         verbWrapper->processor.setParameters (reverbParams);
 
+        fdn8VerbWrapper = std::make_unique<EffectProcessorWrapper<Fdn8VerbProcessor, T>>();
+        fdn8VerbWrapper->processor.setParameters (reverbParams);
+
+        fdn16VerbWrapper = std::make_unique<EffectProcessorWrapper<Fdn16VerbProcessor, T>>();
+        fdn16VerbWrapper->processor.setParameters (reverbParams);
+
         chorusWrapper = std::make_unique<EffectProcessorWrapper<juce::dsp::Chorus<T>, T>>();
         phaserWrapper = std::make_unique<EffectProcessorWrapper<juce::dsp::Phaser<T>, T>>();
     }
 
     void prepare (const juce::dsp::ProcessSpec& spec)
     {
-        fade_buffer1.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
-        fade_buffer2.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        fade_buffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        dry_buffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        verb_fade_buffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        dryGainRamp.allocate (spec.maximumBlockSize, true);
+        mixSmoother.reset (spec.sampleRate, crossfadeDurationSeconds);
 
         verbWrapper->prepare (spec);
+        fdn8VerbWrapper->prepare (spec);
+        fdn16VerbWrapper->prepare (spec);
         chorusWrapper->prepare (spec);
         phaserWrapper->prepare (spec);
 
         effectCrossFader.prepare (spec);
+        verbAlgorithmCrossFader.prepare (spec);
     }
 
 #if LOG_EVERYTHING_AFTER_TRANSITION
@@ -103,7 +88,7 @@ class EffectsProcessor
         if (parameterID == ProPhatParameterIds::reverbParam1ID.getParamID())
         {
             reverbParams.roomSize = static_cast<float> (newValue);
-            verbWrapper->processor.setParameters (reverbParams);
+            setReverbParameters();
         }
         else if (parameterID == ProPhatParameterIds::chorusParam1ID.getParamID())
         {
@@ -116,7 +101,7 @@ class EffectsProcessor
         else if (parameterID == ProPhatParameterIds::reverbParam2ID.getParamID())
         {
             reverbParams.wetLevel = newValue;
-            verbWrapper->processor.setParameters (reverbParams);
+            setReverbParameters();
         }
         else if (parameterID == ProPhatParameterIds::chorusParam2ID.getParamID())
         {
@@ -132,189 +117,351 @@ class EffectsProcessor
             jassertfalse; //unknown effect parameter!
     }
 
-    void changeEffect (EffectType effect)
+    /** Selects which reverb runs when the verb effect is selected. If the verb is playing, the new algorithm
+        starts from silence and we crossfade to it, so the old one fades out instead of getting cut.
+    */
+    void setReverbAlgorithm (ReverbAlgorithm::Values algorithm)
     {
-        effectCrossFader.changeEffect (effect);
+        requestedReverbAlgorithm = algorithm;
+    }
 
-#if LOG_EVERYTHING_AFTER_TRANSITION
-        if (isPlaying)
-            transitionStarted = true;
-#endif
+    /** Requests a new effect. This can be called from any thread, and only gets picked up by the audio
+        thread at the start of the next block, see pollEffectRequest().
+    */
+    void changeEffect (EffectType effect) { selectedEffect = effect; }
+
+    /** A bypassed slot crossfades to no effect, and then isn't processed at all. */
+    void setBypassed (bool shouldBeBypassed) { bypassed = shouldBeBypassed; }
+
+    /** Sets the wet/dry balance of the slot, 1 being fully wet. Like changeEffect(), this can be called from
+        any thread, and the audio thread starts ramping to it at the start of the next block.
+    */
+    void setMix (T newMix) { requestedMix = juce::jlimit (T (0), T (1), newMix); }
+
+    /** Returns how long this slot keeps outputting sound once its input goes silent, assuming it
+        stays on its currently selected effect.
+    */
+    double getTailLengthSeconds() const
+    {
+        //the chorus and phaser only hold a few ms of delay, and don't use any feedback
+        constexpr auto chorusTailSeconds { .05 };
+        constexpr auto phaserTailSeconds { .01 };
+
+        switch (getTargetEffect())
+        {
+            case EffectType::verb:
+                switch (requestedReverbAlgorithm.load())
+                {
+                    case ReverbAlgorithm::fdn8: return fdn8VerbWrapper->processor.getTailLengthSeconds();
+                    case ReverbAlgorithm::fdn16: return fdn16VerbWrapper->processor.getTailLengthSeconds();
+                    case ReverbAlgorithm::classic:
+                    default: return verbWrapper->processor.getTailLengthSeconds();
+                }
+            case EffectType::chorus: return chorusTailSeconds;
+            case EffectType::phaser: return phaserTailSeconds;
+            case EffectType::none:
+            case EffectType::transitioning:
+            default: return 0.;
+        }
     }
 
+    /** Returns true when the slot has nothing to do: no effect, no transition in progress, and none requested. */
+    bool isIdle() const { return effectCrossFader.getCurrentEffectType() == EffectType::none && getTargetEffect() == EffectType::none; }
+
 void process (const juce::dsp::ProcessContextReplacing<T>& context)
 {
-#if ENABLE_CLEAR_EFFECT
-    needToClearEffect = true;
-#endif
+    pollReverbAlgorithmRequest();
+    pollEffectRequest();
+    mixSmoother.setTargetValue (requestedMix.load());
 
     const auto& inputBlock { context.getInputBlock () };
     const auto numSamples { static_cast<int> (inputBlock.getNumSamples ()) };
-    //TODO: surround with trylock or something, although not here because we don't have a proper fallback
     const auto currentEffectType { effectCrossFader.getCurrentEffectType () };
 
-#if ENABLE_DEBUG_LOG
-    DebugLogEntry& debugLogEntry = m_pLogDebug->log[m_pLogDebug->logHead];
-    if (m_pLogDebug != nullptr)
-    {
-        //TODO VB: couldn't I just make a new debug entry?
-        //IMPORTANT! Need to clear all the debug entry fields here so that we overwrite the previous one properly!
-        debugLogEntry.timeSinceLastCall = juce::Time::currentTimeMillis () - cachedProcessCallTime;
-        cachedProcessCallTime = juce::Time::currentTimeMillis ();
-        debugLogEntry.curEffect = static_cast<int> (effectCrossFader.getCurrentEffectType ());
-        debugLogEntry.firstGain = {};
-        debugLogEntry.lastGain = {};
+    if (currentEffectType == EffectType::none)
+    {
+        updateEffectStates (EffectType::none, EffectType::none);
+        return;
     }
-#endif
 
-    if (currentEffectType == EffectType::transitioning)
+    //keep the dry signal around if we need to blend it back in
+    const auto needsDry { mixSmoother.isSmoothing() || mixSmoother.getTargetValue() < T (1) };
+    if (needsDry)
     {
-#if ENABLE_DEBUG_LOG
-        effectCrossFader.setDebugLogEntry (&debugLogEntry);
-#endif
-        jassert (fade_buffer1.getNumSamples() >= numSamples && fade_buffer2.getNumSamples() >= numSamples);
-
-        //copy the OG buffer into the individual processor ones
+        jassert (dry_buffer.getNumSamples() >= numSamples);
         for (auto c = 0; c < (int) inputBlock.getNumChannels (); ++c)
-        {
-            //TODO VB: look into copyFromWithRamp!!! we could probably use this to do the crossfade
-            fade_buffer1.copyFrom (c, 0, inputBlock.getChannelPointer (c), numSamples);
-            fade_buffer2.copyFrom (c, 0, inputBlock.getChannelPointer (c), numSamples);
-        }
-
-        auto block1 { juce::dsp::AudioBlock<T> (fade_buffer1).getSubBlock ((size_t) 0, (size_t) numSamples) };
-        auto context1 { juce::dsp::ProcessContextReplacing<T> (block1) };
+            dry_buffer.copyFrom (c, 0, inputBlock.getChannelPointer (c), numSamples);
+    }
 
-        auto block2 { juce::dsp::AudioBlock<T> (fade_buffer2).getSubBlock ((size_t) 0, (size_t) numSamples) };
-        auto context2 { juce::dsp::ProcessContextReplacing<T> (block2) };
+    if (currentEffectType == EffectType::transitioning)
+    {
+        jassert (fade_buffer.getNumSamples() >= numSamples);
 
         //do the crossfade between the previous and next effects
         const auto prevEffect = effectCrossFader.prevEffect;
         const auto nextEffect = effectCrossFader.curEffect;
+        updateEffectStates (nextEffect, prevEffect);
 
-        switch (prevEffect)
-        {
-        case EffectType::none:
-            break;
-        case EffectType::verb:
-            verbWrapper->process (context1);
-            break;
-        case EffectType::chorus:
-            chorusWrapper->process (context1);
-            break;
-        case EffectType::phaser:
-            phaserWrapper->process (context1);
-            break;
-        case EffectType::transitioning:
-        default:
-            jassertfalse;
-            break;
-        }
+        //the previous effect gets a copy of the input, and the next effect processes the input in place
+        for (auto c = 0; c < (int) inputBlock.getNumChannels (); ++c)
+            fade_buffer.copyFrom (c, 0, inputBlock.getChannelPointer (c), numSamples);
+
+        auto block1 { juce::dsp::AudioBlock<T> (fade_buffer).getSubBlock ((size_t) 0, (size_t) numSamples) };
+        auto context1 { juce::dsp::ProcessContextReplacing<T> (block1) };
+
+        processEffect (prevEffect, context1);
+        processEffect (nextEffect, context);
 
-        switch (nextEffect)
-        {
-        case EffectType::none:
-            break;
-        case EffectType::verb:
-            verbWrapper->process (context2);
-            break;
-        case EffectType::chorus:
-            chorusWrapper->process (context2);
-            break;
-        case EffectType::phaser:
-            phaserWrapper->process (context2);
-            break;
-        case EffectType::transitioning:
-        default:
-            jassertfalse;
-            break;
-        }
         //crossfade the 2 effects
-        effectCrossFader.process (fade_buffer1, fade_buffer2, context);
+        effectCrossFader.process (fade_buffer, context);
+
+        if (effectCrossFader.getCurrentEffectType() != EffectType::transitioning)
+            TRACE_EVENT (TraceEventType::effectTransitionEnd, slotIndex, (int) prevEffect, (int) nextEffect);
     }
     else
     {
-        if (currentEffectType == EffectType::verb)
+        updateEffectStates (currentEffectType, EffectType::none);
+        processEffect (currentEffectType, context);
+    }
+
+    if (needsDry)
+        blendDry (context, numSamples);
+
+    //if we just finished transitioning to no effect, whatever was tailing is now dormant
+    if (isIdle())
+        updateEffectStates (EffectType::none, EffectType::none);
+
+#if LOG_EVERYTHING_AFTER_TRANSITION
+    if (transitionStarted)
+    {
+        int asdf = 0;
+        for (int i = 0; i < numSamples; ++i)
+            DBG (inputBlock.getChannelPointer (0)[i]);
+        ++asdf;
+    }
+#endif
+}
+
+  private:
+    EffectType getTargetEffect() const { return bypassed ? EffectType::none : selectedEffect.load(); }
+
+    /** The audio thread owns the crossfader, and this is the only place where it changes effects. Requests that
+        come in mid-crossfade aren't dropped: we go to the latest one once the crossfade is done, or turn the
+        crossfade around right away if it asks for the effect we're fading out.
+    */
+    void pollEffectRequest()
+    {
+        const auto targetEffect { getTargetEffect() };
+
+        if (effectCrossFader.getCurrentEffectType() == EffectType::transitioning)
         {
-            verbWrapper->process (context);
-#if ENABLE_CLEAR_EFFECT
-            if (needToClearEffect)
+            if (targetEffect == effectCrossFader.prevEffect)
             {
-                phaserWrapper->reset ();
-                chorusWrapper->reset ();
-                needToClearEffect = false;
+                effectCrossFader.reverse();
+                TRACE_EVENT (TraceEventType::effectTransitionReverse, slotIndex, (int) effectCrossFader.prevEffect, (int) effectCrossFader.curEffect);
             }
-#endif
+
+            return;
         }
-        else if (currentEffectType == EffectType::chorus)
+
+        if (targetEffect == effectCrossFader.curEffect)
+            return;
+
+        effectCrossFader.changeEffect (targetEffect);
+        TRACE_EVENT (TraceEventType::effectTransitionBegin, slotIndex, (int) effectCrossFader.prevEffect, (int) effectCrossFader.curEffect);
+
+#if LOG_EVERYTHING_AFTER_TRANSITION
+        if (isPlaying)
+            transitionStarted = true;
+#endif
+    }
+
+    /** Same idea as pollEffectRequest(), but for the reverb algorithm. When the verb is dormant nobody can hear
+        the old algorithm, so we switch right away. Otherwise we crossfade, which reuses an EffectsCrossfadeProcessor
+        for its gain ramp only: the algorithms themselves are tracked here, in prevReverbAlgorithm and reverbAlgorithm.
+    */
+    void pollReverbAlgorithmRequest()
+    {
+        const auto requested { requestedReverbAlgorithm.load() };
+
+        if (verbAlgorithmCrossFader.getCurrentEffectType() == EffectType::transitioning)
         {
-            chorusWrapper->process (context);
-#if ENABLE_CLEAR_EFFECT
-            if (needToClearEffect)
+            if (requested == prevReverbAlgorithm)
             {
-                verbWrapper->reset ();
-                phaserWrapper->reset ();
-                needToClearEffect = false;
+                verbAlgorithmCrossFader.reverse();
+                std::swap (prevReverbAlgorithm, reverbAlgorithm);
             }
-#endif
+
+            return;
         }
-        else if (currentEffectType == EffectType::phaser)
+
+        if (requested == reverbAlgorithm)
+            return;
+
+        //the new algorithm may still hold whatever it was ringing the last time it was used
+        resetVerb (requested);
+        prevReverbAlgorithm = std::exchange (reverbAlgorithm, requested);
+
+        if (effectLifecycles[(size_t) EffectType::verb].state != EffectState::dormant)
+            verbAlgorithmCrossFader.changeEffect (EffectType::verb);
+    }
+
+    /** out = wet * mix + dry * (1 - mix) = wet + (dry - wet) * (1 - mix) */
+    void blendDry (const juce::dsp::ProcessContextReplacing<T>& context, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dryGainRamp[i] = T (1) - mixSmoother.getNextValue();
+
+        auto& outputBlock { context.getOutputBlock() };
+        for (int c = 0; c < (int) outputBlock.getNumChannels(); ++c)
         {
-            phaserWrapper->process (context);
-#if ENABLE_CLEAR_EFFECT
-            if (needToClearEffect)
-            {
-                chorusWrapper->reset ();
-                verbWrapper->reset ();
-                needToClearEffect = false;
-            }
-#endif
+            auto* dryData = dry_buffer.getWritePointer (c);
+            auto* outData = outputBlock.getChannelPointer (c);
+
+            juce::FloatVectorOperations::subtract (dryData, outData, numSamples);
+            juce::FloatVectorOperations::addWithMultiply (outData, dryData, dryGainRamp.getData(), numSamples);
         }
-        else if (currentEffectType == EffectType::none)
+    }
+
+    using Fdn8VerbProcessor  = PhatVerbProcessor<T, PhatFdnVerb<T, 8, FdnMixing::householder>>;
+    using Fdn16VerbProcessor = PhatVerbProcessor<T, PhatFdnVerb<T, 16, FdnMixing::hadamard>>;
+
+    void setReverbParameters()
+    {
+        verbWrapper->processor.setParameters (reverbParams);
+        fdn8VerbWrapper->processor.setParameters (reverbParams);
+        fdn16VerbWrapper->processor.setParameters (reverbParams);
+    }
+
+    void processVerb (const juce::dsp::ProcessContextReplacing<T>& context)
+    {
+        if (verbAlgorithmCrossFader.getCurrentEffectType() != EffectType::transitioning)
         {
-#if ENABLE_CLEAR_EFFECT
-            if (needToClearEffect)
-            {
-                verbWrapper->reset ();
-                chorusWrapper->reset ();
-                phaserWrapper->reset ();
-                needToClearEffect = false;
-            }
-#endif
+            processVerb (reverbAlgorithm, context);
+            return;
         }
-        else
-            jassertfalse; //unknown effect!!
+
+        //same as the effect crossfade: the previous algorithm gets a copy of the input, and the next one
+        //processes the input in place. The context may already be fade_buffer, so we use our own buffer
+        const auto& inputBlock { context.getInputBlock() };
+        const auto  numSamples { (int) inputBlock.getNumSamples() };
+        jassert (verb_fade_buffer.getNumSamples() >= numSamples);
+
+        for (auto c = 0; c < (int) inputBlock.getNumChannels(); ++c)
+            verb_fade_buffer.copyFrom (c, 0, inputBlock.getChannelPointer (c), numSamples);
+
+        auto prevBlock { juce::dsp::AudioBlock<T> (verb_fade_buffer).getSubBlock ((size_t) 0, (size_t) numSamples) };
+        processVerb (prevReverbAlgorithm, juce::dsp::ProcessContextReplacing<T> (prevBlock));
+        processVerb (reverbAlgorithm, context);
+
+        verbAlgorithmCrossFader.process (verb_fade_buffer, context);
     }
 
-#if LOG_EVERYTHING_AFTER_TRANSITION
-    if (transitionStarted)
+    void processVerb (ReverbAlgorithm::Values algorithm, const juce::dsp::ProcessContextReplacing<T>& context)
     {
-        int asdf = 0;
-        for (int i = 0; i < numSamples; ++i)
-            DBG (inputBlock.getChannelPointer (0)[i]);
-        ++asdf;
+        switch (algorithm)
+        {
+            case ReverbAlgorithm::fdn8: fdn8VerbWrapper->process (context); break;
+            case ReverbAlgorithm::fdn16: fdn16VerbWrapper->process (context); break;
+            case ReverbAlgorithm::classic:
+            default: verbWrapper->process (context); break;
+        }
     }
-#endif
 
-#if ENABLE_DEBUG_LOG
-    debugLogEntry.processCallDuration = juce::Time::currentTimeMillis () - cachedProcessCallTime;
-    m_pLogDebug->logHead = (m_pLogDebug->logHead + 1) & (kMaxDebugEntries - 1);
-#endif
-}
+    void resetVerb (ReverbAlgorithm::Values algorithm)
+    {
+        switch (algorithm)
+        {
+            case ReverbAlgorithm::fdn8: fdn8VerbWrapper->reset(); break;
+            case ReverbAlgorithm::fdn16: fdn16VerbWrapper->reset(); break;
+            case ReverbAlgorithm::classic:
+            default: verbWrapper->reset(); break;
+        }
+    }
 
-  private:
-#if ENABLE_CLEAR_EFFECT
-    bool needToClearEffect { false };
-#endif
-#if ENABLE_DEBUG_LOG
-    juce::int64                             cachedProcessCallTime { juce::Time::currentTimeMillis() };
-    std::unique_ptr<juce::MemoryMappedFile> m_pLogDebugMapping {};
-    DebugLog*                               m_pLogDebug {};
-#endif
+    /** An effect is active when it's the selected one, tailing while it's being crossfaded out, and dormant
+        otherwise. Dormant effects aren't processed, and an effect that went dormant still holds whatever it
+        was ringing, so we clear it once, right before it gets processed again.
+    */
+    enum class EffectState
+    {
+        dormant = 0,
+        active,
+        tailing
+    };
+
+    struct EffectLifecycle
+    {
+        EffectState state { EffectState::dormant };
+        bool        needsClear { false };
+    };
+
+    //indexed by EffectType, without EffectType::transitioning
+    std::array<EffectLifecycle, (size_t) EffectType::transitioning> effectLifecycles {};
+
+    void updateEffectStates (EffectType activeEffect, EffectType tailingEffect)
+    {
+        for (size_t i = 0; i < effectLifecycles.size(); ++i)
+        {
+            auto&      lifecycle { effectLifecycles[i] };
+            const auto newState { i == (size_t) activeEffect    ? EffectState::active
+                                  : i == (size_t) tailingEffect ? EffectState::tailing
+                                                                : EffectState::dormant };
+
+            if (newState == EffectState::dormant && lifecycle.state != EffectState::dormant)
+                lifecycle.needsClear = true;
+
+            lifecycle.state = newState;
+        }
+    }
+
+    void processEffect (EffectType effect, const juce::dsp::ProcessContextReplacing<T>& context)
+    {
+        auto& lifecycle { effectLifecycles[(size_t) effect] };
+        jassert (lifecycle.state != EffectState::dormant);
+
+        switch (effect)
+        {
+            case EffectType::none:
+                break;
+            case EffectType::verb:
+                //an algorithm crossfade may have been cut short when the verb went dormant, so clear both
+                if (std::exchange (lifecycle.needsClear, false))
+                {
+                    resetVerb (reverbAlgorithm);
+                    resetVerb (prevReverbAlgorithm);
+                }
+                processVerb (context);
+                break;
+            case EffectType::chorus:
+                if (std::exchange (lifecycle.needsClear, false))
+                    chorusWrapper->reset();
+                chorusWrapper->process (context);
+                break;
+            case EffectType::phaser:
+                if (std::exchange (lifecycle.needsClear, false))
+                    phaserWrapper->reset();
+                phaserWrapper->process (context);
+                break;
+            case EffectType::transitioning:
+            default:
+                jassertfalse; //unknown effect!!
+                break;
+        }
+    }
 
     std::unique_ptr<EffectProcessorWrapper<juce::dsp::Chorus<T>, T>> chorusWrapper;
     std::unique_ptr<EffectProcessorWrapper<juce::dsp::Phaser<T>, T>> phaserWrapper;
     std::unique_ptr<EffectProcessorWrapper<PhatVerbProcessor<T>, T>> verbWrapper;
+    std::unique_ptr<EffectProcessorWrapper<Fdn8VerbProcessor, T>>    fdn8VerbWrapper;
+    std::unique_ptr<EffectProcessorWrapper<Fdn16VerbProcessor, T>>   fdn16VerbWrapper;
+
+    //reverbAlgorithm and prevReverbAlgorithm are owned by the audio thread, see pollReverbAlgorithmRequest()
+    ReverbAlgorithm::Values              reverbAlgorithm { ReverbAlgorithm::classic };
+    ReverbAlgorithm::Values              prevReverbAlgorithm { ReverbAlgorithm::classic };
+    std::atomic<ReverbAlgorithm::Values> requestedReverbAlgorithm { ReverbAlgorithm::classic };
+    EffectsCrossfadeProcessor<T>         verbAlgorithmCrossFader;
+    juce::AudioBuffer<T>                 verb_fade_buffer;
 
     PhatVerbParameters<T>                                            reverbParams {
         //manually setting all these because we need to set the default room size and wet level to 0 if we want to be able to retrieve
@@ -328,6 +475,132 @@ void process (const juce::dsp::ProcessContextReplacing<T>& context)
         static_cast<T> (0)    //< Freeze mode - values < 0.5 are "normal" mode, values > 0.5 put the reverb into a continuous feedback loop.
     };
 
-    juce::AudioBuffer<T>         fade_buffer1, fade_buffer2;
+    juce::AudioBuffer<T>         fade_buffer;
     EffectsCrossfadeProcessor<T> effectCrossFader;
+
+    //where we are in the effect chain, only used to tell slots apart in the trace
+    [[maybe_unused]] const int slotIndex;
+
+    //written by whichever thread changes the parameters, and polled by the audio thread
+    std::atomic<EffectType> selectedEffect;
+    std::atomic<bool>       bypassed { false };
+    std::atomic<T>          requestedMix { T (1) };
+
+    //only touched by the audio thread
+    juce::SmoothedValue<T> mixSmoother { T (1) };
+    juce::AudioBuffer<T>   dry_buffer;
+    juce::HeapBlock<T>     dryGainRamp;
+};
+
+//==============================================================================
+
+/** A serial chain of Constants::numEffectSlots effect slots. Every time the slot configuration changes we
+    resolve the list of slots that actually need processing, so bypassed and empty slots cost nothing.
+*/
+template <std::floating_point T>
+class EffectsProcessor
+{
+  public:
+    EffectsProcessor()
+    {
+        //the first slot starts on the verb like the single effect processor used to
+        for (size_t i = 0; i < slots.size(); ++i)
+            slots[i] = std::make_unique<EffectSlot<T>> (i == 0 ? EffectType::verb : EffectType::none, (int) i);
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        for (auto& slot : slots)
+            slot->prepare (spec);
+    }
+
+#if LOG_EVERYTHING_AFTER_TRANSITION
+    void setIsPlaying (bool pIsPlaying)
+    {
+        for (auto& slot : slots)
+            slot->setIsPlaying (pIsPlaying);
+    }
+#endif
+
+    /** Effect parameters are per effect type, so they apply to that effect in every slot. */
+    void setEffectParam (juce::StringRef parameterID, T newValue)
+    {
+        for (auto& slot : slots)
+            slot->setEffectParam (parameterID, newValue);
+    }
+
+    void setReverbAlgorithm (ReverbAlgorithm::Values algorithm)
+    {
+        for (auto& slot : slots)
+            slot->setReverbAlgorithm (algorithm);
+    }
+
+    /** Changes the effect of the first slot. */
+    void changeEffect (EffectType effect) { changeEffect (0, effect); }
+
+    void changeEffect (int slotIndex, EffectType effect)
+    {
+        slots[(size_t) slotIndex]->changeEffect (effect);
+        ++configVersion;
+    }
+
+    void setSlotBypassed (int slotIndex, bool shouldBeBypassed)
+    {
+        slots[(size_t) slotIndex]->setBypassed (shouldBeBypassed);
+        ++configVersion;
+    }
+
+    void setSlotMix (int slotIndex, T newMix) { slots[(size_t) slotIndex]->setMix (newMix); }
+
+    /** The slots are in series, so their tails add up. */
+    double getTailLengthSeconds() const
+    {
+        auto tail { 0. };
+        for (const auto& slot : slots)
+            tail += slot->getTailLengthSeconds();
+
+        return tail;
+    }
+
+    void process (const juce::dsp::ProcessContextReplacing<T>& context)
+    {
+        if (const auto version { configVersion.load() }; version != resolvedConfigVersion || needToResolve)
+        {
+            resolvedConfigVersion = version;
+            resolveProcessingList();
+        }
+
+        TRACE_EVENT (TraceEventType::effectsBegin, -1, numSlotsToProcess);
+
+        for (int i = 0; i < numSlotsToProcess; ++i)
+        {
+            processingList[(size_t) i]->process (context);
+
+            //once a slot is done transitioning to nothing, we can drop it from the list
+            needToResolve |= processingList[(size_t) i]->isIdle();
+        }
+
+        TRACE_EVENT (TraceEventType::effectsEnd);
+    }
+
+  private:
+    void resolveProcessingList()
+    {
+        numSlotsToProcess = 0;
+        for (auto& slot : slots)
+            if (! slot->isIdle())
+                processingList[(size_t) numSlotsToProcess++] = slot.get();
+
+        needToResolve = false;
+    }
+
+    std::array<std::unique_ptr<EffectSlot<T>>, Constants::numEffectSlots> slots;
+
+    //the slots that aren't idle, in chain order
+    std::array<EffectSlot<T>*, Constants::numEffectSlots> processingList {};
+    int                                                    numSlotsToProcess { 0 };
+
+    std::atomic<int> configVersion { 0 };
+    int              resolvedConfigVersion { -1 };
+    bool             needToResolve { true };
 };
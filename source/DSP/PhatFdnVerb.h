@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PhatVerb.h"
+#include <bit>
+#include <utility>
+
+/** How the delay lines of a PhatFdnVerb are mixed back into each other. */
+enum class FdnMixing
+{
+    householder, // I - 2/N: one sum per sample, but each line mostly feeds back into itself
+    hadamard     // fast Walsh-Hadamard transform: N log2(N) adds, and every line feeds every other one equally
+};
+
+/** A feedback delay network reverb, an alternative to PhatVerb's comb/allpass topology.
+
+    All delay lines share one interleaved, power-of-two sized delay memory and a single write position, so
+    every per-sample step is a straight loop over lanes, the same way PhatVerb runs its combs. Decay and damping
+    are smoothed once per chunk of samples, and the decay is applied per line so that every line loses the same
+    amount of energy per second regardless of its length.
+
+    It uses the same PhatVerbParameters as PhatVerb, so the two can be swapped behind the same effect parameters.
+*/
+template <std::floating_point T, int numLines, FdnMixing mixing>
+class PhatFdnVerb
+{
+    static_assert (numLines == 8 || numLines == 16, "the Hadamard matrix and the delay tunings need 8 or 16 lines");
+
+  public:
+    PhatFdnVerb()
+    {
+        setParameters (PhatVerbParameters<T>());
+        setSampleRate (44100.0);
+    }
+
+    /** Returns the reverb's current parameters. */
+    const PhatVerbParameters<T>& getParameters() const noexcept { return parameters; }
+
+    /** Applies a new set of parameters to the reverb. */
+    void setParameters (const PhatVerbParameters<T>& newParams)
+    {
+        const T wetScaleFactor = 3.0;
+        const T dryScaleFactor = 2.0;
+
+        const T wet = newParams.wetLevel * wetScaleFactor;
+        dryGain.setTargetValue (newParams.dryLevel * dryScaleFactor);
+        wetGain1.setTargetValue (static_cast<T> (0.5 * wet * (1.0 + newParams.width)));
+        wetGain2.setTargetValue (static_cast<T> (0.5 * wet * (1.0 - newParams.width)));
+
+        gain       = static_cast<T> (isFrozen (newParams.freezeMode) ? 0.0 : 0.3);
+        parameters = newParams;
+        updateDecay();
+    }
+
+    /** Returns how long the reverb takes to decay by 60 dB, or infinity when it's frozen. */
+    double getTailLengthSeconds() const noexcept
+    {
+        return isFrozen (parameters.freezeMode) ? std::numeric_limits<double>::infinity() : getRt60 (parameters.roomSize);
+    }
+
+    /** Sets the sample rate, and (re)allocates the delay lines. Call this before processing. */
+    void setSampleRate (const double newSampleRate)
+    {
+        jassert (newSampleRate > 0);
+        sampleRate = newSampleRate;
+
+        // mutually prime lengths (at 44100Hz), roughly exponentially spread between 30 and 100 ms
+        static constexpr int delayTunings[] = { 1327, 1433, 1559, 1693, 1847, 1999, 2179, 2371,
+                                                2579, 2803, 3049, 3319, 3613, 3929, 4271, 4649 };
+
+        // with 8 lines we take every other tuning, so we still cover the whole range
+        constexpr auto tuningStride { 16 / numLines };
+        for (int l = 0; l < numLines; ++l)
+            delayLengths[(size_t) l] = juce::jmax ((int) chunkSize, (int) (sampleRate * delayTunings[l * tuningStride] / 44100.0));
+
+        const auto capacity { juce::nextPowerOfTwo (delayLengths[numLines - 1]) };
+        buffer.malloc ((size_t) capacity * numLines);
+        mask     = capacity - 1;
+        writePos = 0;
+
+        const double smoothTime = 0.01;
+        damping.reset (sampleRate, smoothTime);
+        decay.reset (sampleRate, smoothTime);
+        dryGain.reset (sampleRate, smoothTime);
+        wetGain1.reset (sampleRate, smoothTime);
+        wetGain2.reset (sampleRate, smoothTime);
+
+        updateDecay();
+        decay.setCurrentAndTargetValue (decay.getTargetValue());
+        updateLineGains (decay.getTargetValue());
+
+        reset();
+    }
+
+    /** Clears the reverb's buffers. */
+    void reset()
+    {
+        buffer.clear ((size_t) (mask + 1) * numLines);
+        filtered.fill (0);
+    }
+
+    /** Applies the reverb to two stereo channels of audio data. */
+    void processStereo (T* const left, T* const right, const int numSamples) noexcept
+    {
+        jassert (left != nullptr && right != nullptr);
+
+        const juce::ScopedNoDenormals noDenormals;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const auto curChunkSize { juce::jmin ((int) chunkSize, numSamples - start) };
+            auto* const chunkLeft { left + start };
+            auto* const chunkRight { right + start };
+
+            prepareChunk (curChunkSize);
+
+            for (int i = 0; i < curChunkSize; ++i)
+            {
+                const auto [outL, outR] = processSample ((chunkLeft[i] + chunkRight[i]) * gain);
+
+                const T dry  = dryGain.getNextValue();
+                const T wet1 = wetGain1.getNextValue();
+                const T wet2 = wetGain2.getNextValue();
+
+                chunkLeft[i]  = outL * wet1 + outR * wet2 + chunkLeft[i] * dry;
+                chunkRight[i] = outR * wet1 + outL * wet2 + chunkRight[i] * dry;
+            }
+        }
+    }
+
+    /** Applies the reverb to a single mono channel of audio data. */
+    void processMono (T* const samples, const int numSamples) noexcept
+    {
+        jassert (samples != nullptr);
+
+        const juce::ScopedNoDenormals noDenormals;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const auto curChunkSize { juce::jmin ((int) chunkSize, numSamples - start) };
+            auto* const chunk { samples + start };
+
+            prepareChunk (curChunkSize);
+
+            for (int i = 0; i < curChunkSize; ++i)
+            {
+                const auto output { processSample (chunk[i] * gain).first };
+
+                const T dry  = dryGain.getNextValue();
+                const T wet1 = wetGain1.getNextValue();
+
+                chunk[i] = output * wet1 + chunk[i] * dry;
+            }
+        }
+    }
+
+  private:
+    enum
+    {
+        chunkSize = 32
+    };
+
+    static bool isFrozen (const T freezeMode) noexcept { return freezeMode >= 0.5; }
+
+    /** RT60, i.e. the time to decay by 60 dB or a gain of 10^-3, spread exponentially over the room size. */
+    static double getRt60 (T roomSize) noexcept
+    {
+        const auto minDecaySeconds { 0.3 };
+        const auto maxDecaySeconds { 10. };
+
+        return minDecaySeconds * std::pow (maxDecaySeconds / minDecaySeconds, (double) roomSize);
+    }
+
+    /** The decay is smoothed as a log-gain per sample, 0 meaning no decay at all. */
+    void updateDecay() noexcept
+    {
+        const auto dampScaleFactor { static_cast<T> (0.4) };
+
+        if (isFrozen (parameters.freezeMode))
+        {
+            damping.setTargetValue (0);
+            decay.setTargetValue (0);
+            return;
+        }
+
+        const auto rt60 { getRt60 (parameters.roomSize) };
+
+        damping.setTargetValue (parameters.damping * dampScaleFactor);
+        decay.setTargetValue (static_cast<T> (-3. * std::log (10.) / (rt60 * sampleRate)));
+    }
+
+    void updateLineGains (const T logGainPerSample) noexcept
+    {
+        for (int l = 0; l < numLines; ++l)
+            lineGains[(size_t) l] = std::exp (logGainPerSample * static_cast<T> (delayLengths[(size_t) l]));
+    }
+
+    void prepareChunk (const int curChunkSize) noexcept
+    {
+        curDamping = damping.skip (curChunkSize);
+
+        if (decay.isSmoothing())
+            updateLineGains (decay.skip (curChunkSize));
+    }
+
+    /** Runs one sample through the network, and returns the left and right outputs. */
+    std::pair<T, T> processSample (const T input) noexcept
+    {
+        auto* const writeFrame { buffer.getData() + writePos * numLines };
+
+        for (int l = 0; l < numLines; ++l)
+            filtered[(size_t) l] = buffer[((writePos - delayLengths[(size_t) l]) & mask) * numLines + l] * (1 - curDamping)
+                                 + filtered[(size_t) l] * curDamping;
+
+        // the outputs are tapped from 2 orthogonal rows of the Hadamard matrix, so they're decorrelated
+        T outL = 0, outR = 0;
+        for (int l = 0; l < numLines; ++l)
+        {
+            outL += hadamardSign (1, l) * filtered[(size_t) l];
+            outR += hadamardSign (2, l) * filtered[(size_t) l];
+        }
+
+        mixed = filtered;
+        mix (mixed);
+
+        // the input is spread with yet another row, which isn't the all-ones eigenvector of the Householder matrix
+        for (int l = 0; l < numLines; ++l)
+            writeFrame[l] = mixed[(size_t) l] * lineGains[(size_t) l] + hadamardSign (numLines - 1, l) * input;
+
+        writePos = (writePos + 1) & mask;
+
+        return { outL * outputScale, outR * outputScale };
+    }
+
+    static void mix (std::array<T, numLines>& lines) noexcept
+    {
+        if constexpr (mixing == FdnMixing::householder)
+        {
+            T sum = 0;
+            for (const auto line : lines)
+                sum += line;
+
+            const auto reflection { sum * static_cast<T> (2. / numLines) };
+            for (auto& line : lines)
+                line -= reflection;
+        }
+        else
+        {
+            for (int h = 1; h < numLines; h *= 2)
+            {
+                for (int i = 0; i < numLines; i += 2 * h)
+                {
+                    for (int j = i; j < i + h; ++j)
+                    {
+                        const auto a { lines[(size_t) j] };
+                        const auto b { lines[(size_t) (j + h)] };
+                        lines[(size_t) j]       = a + b;
+                        lines[(size_t) (j + h)] = a - b;
+                    }
+                }
+            }
+
+            for (auto& line : lines)
+                line *= outputScale;
+        }
+    }
+
+    /** Sign of the element (row, column) of the Sylvester-Hadamard matrix. */
+    static constexpr T hadamardSign (const int row, const int column) noexcept
+    {
+        return std::popcount (static_cast<unsigned> (row & column)) % 2 == 0 ? T (1) : T (-1);
+    }
+
+    // 1/sqrt(numLines), which keeps the Hadamard matrix and the output taps energy-preserving
+    static constexpr T outputScale { numLines == 8 ? T (0.35355339059327373) : T (0.25) };
+
+    PhatVerbParameters<T> parameters;
+    T                     gain;
+    double                sampleRate { 44100. };
+
+    juce::HeapBlock<T>                   buffer;
+    int                                  mask = 0, writePos = 0;
+    std::array<int, numLines>            delayLengths {};
+    alignas (32) std::array<T, numLines> filtered {}, mixed {}, lineGains {};
+    T                                    curDamping { 0 };
+
+    juce::SmoothedValue<T> damping, decay, dryGain, wetGain1, wetGain2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhatFdnVerb)
+};
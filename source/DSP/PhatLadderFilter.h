@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Utility/Helpers.h"
+
+/**
+ * @brief This is copied over from juce::dsp::LadderFilter, with an extra process() overload that takes one
+    cutoff value per sample. That audio-rate path skips the cutoff smoother and the std::exp() call in
+    setCutoffFrequencyHz(), and instead gets its coefficient from a lookup table, so modulating the cutoff on
+    every sample costs about the same as processing with a fixed cutoff.
+
+    When useFastSaturation is true, the input and the feedback path are saturated with a rational tanh
+    approximation instead of the lookup table, which trades a table read for a division on each of them.
+*/
+template <std::floating_point T, bool useFastSaturation = false>
+class PhatLadderFilter
+{
+  public:
+    enum class Mode
+    {
+        LPF12, // low-pass  12 dB/octave
+        HPF12, // high-pass 12 dB/octave
+        BPF12, // band-pass 12 dB/octave
+        LPF24, // low-pass  24 dB/octave
+        HPF24, // high-pass 24 dB/octave
+        BPF24  // band-pass 24 dB/octave
+    };
+
+    PhatLadderFilter()
+        : state (2)
+    {
+        setSampleRate (T (1000)); // intentionally setting unrealistic default sample rate to catch missing initialisation bugs
+        setResonance (T (0));
+        setDrive (T (1.2));
+
+        mode = Mode::LPF24;
+        setMode (Mode::LPF12);
+    }
+
+    /** Enables or disables the filter. If disabled it will simply pass through the input signal. */
+    void setEnabled (bool isEnabled) noexcept { enabled = isEnabled; }
+
+    /** Sets filter mode. */
+    void setMode (Mode newMode) noexcept
+    {
+        if (newMode == mode)
+            return;
+
+        switch (newMode)
+        {
+            case Mode::LPF12: A = { { T (0), T (0), T (1), T (0), T (0) } };    comp = T (0.5); break;
+            case Mode::HPF12: A = { { T (1), T (-2), T (1), T (0), T (0) } };   comp = T (0);   break;
+            case Mode::BPF12: A = { { T (0), T (0), T (-1), T (1), T (0) } };   comp = T (0.5); break;
+            case Mode::LPF24: A = { { T (0), T (0), T (0), T (0), T (1) } };    comp = T (0.5); break;
+            case Mode::HPF24: A = { { T (1), T (-4), T (6), T (-4), T (1) } };  comp = T (0);   break;
+            case Mode::BPF24: A = { { T (0), T (0), T (4), T (-8), T (4) } };   comp = T (0.5); break;
+            default: jassertfalse; break;
+        }
+
+        static constexpr auto outputGain = T (1.2);
+
+        for (auto& a : A)
+            a *= outputGain;
+
+        mode = newMode;
+        reset();
+    }
+
+    /** Initialises the filter. */
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        setSampleRate (T (spec.sampleRate));
+        setNumChannels (spec.numChannels);
+        reset();
+    }
+
+    /** Returns the current number of channels. */
+    size_t getNumChannels() const noexcept { return state.size(); }
+
+    /** Resets the internal state variables of the filter. */
+    void reset() noexcept
+    {
+        for (auto& s : state)
+            s.fill (T (0));
+
+        cutoffTransformSmoother.setCurrentAndTargetValue (cutoffTransformSmoother.getTargetValue());
+        scaledResonanceSmoother.setCurrentAndTargetValue (scaledResonanceSmoother.getTargetValue());
+    }
+
+    /** Sets the cutoff frequency of the filter, which is smoothed by the non audio-rate process(). */
+    void setCutoffFrequencyHz (T newCutoff) noexcept
+    {
+        jassert (newCutoff > T (0));
+        cutoffFreqHz = newCutoff;
+        updateCutoffFreq();
+    }
+
+    /** Sets the resonance of the filter. @param newResonance a value between 0 and 1 */
+    void setResonance (T newResonance) noexcept
+    {
+        jassert (newResonance >= T (0) && newResonance <= T (1));
+        resonance = newResonance;
+        updateResonance();
+    }
+
+    /** Sets the amount of saturation in the filter. @param newDrive saturation amount; it can be any number greater than or equal to one */
+    void setDrive (T newDrive) noexcept
+    {
+        jassert (newDrive >= T (1));
+
+        drive  = newDrive;
+        gain   = std::pow (drive, T (-2.642)) * T (0.6103) + T (0.3903);
+        drive2 = drive * T (0.04) + T (0.96);
+        gain2  = std::pow (drive2, T (-2.642)) * T (0.6103) + T (0.3903);
+    }
+
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock  = context.getInputBlock();
+        auto&       outputBlock = context.getOutputBlock();
+        const auto  numChannels = outputBlock.getNumChannels();
+        const auto  numSamples  = outputBlock.getNumSamples();
+
+        jassert (inputBlock.getNumChannels() <= getNumChannels());
+        jassert (inputBlock.getNumChannels() == numChannels);
+        jassert (inputBlock.getNumSamples() == numSamples);
+
+        if (! enabled || context.isBypassed)
+        {
+            outputBlock.copyFrom (inputBlock);
+            return;
+        }
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            updateSmoothers();
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                outputBlock.getChannelPointer (ch)[n] = processSample (inputBlock.getChannelPointer (ch)[n], ch);
+        }
+    }
+
+    /** Filters the block in place, using cutoffHz[n] as the cutoff frequency for sample n. cutoffHz needs to hold
+        at least block.getNumSamples() values. The cutoff is not smoothed, so whatever generates it is expected to be continuous.
+    */
+    void process (const juce::dsp::AudioBlock<T>& block, const T* cutoffHz) noexcept
+    {
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = block.getNumSamples();
+
+        jassert (numChannels <= getNumChannels());
+        jassert (cutoffHz != nullptr);
+
+        if (! enabled)
+            return;
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            cutoffTransformValue = getCutoffTransform (cutoffHz[n]);
+            scaledResonanceValue = scaledResonanceSmoother.getNextValue();
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto* channel = block.getChannelPointer (ch);
+                channel[n]    = processSample (channel[n], ch);
+            }
+        }
+
+        //keep the smoothed path in sync, in case we go back to it
+        if (numSamples > 0)
+            cutoffTransformSmoother.setCurrentAndTargetValue (cutoffTransformValue);
+    }
+
+  protected:
+    T processSample (T inputValue, size_t channelToUse) noexcept
+    {
+        auto& s = state[channelToUse];
+
+        const auto a1 = cutoffTransformValue;
+        const auto g  = a1 * T (-1) + T (1);
+        const auto b0 = g * T (0.76923076923);
+        const auto b1 = g * T (0.23076923076);
+
+        T dx, a;
+        if constexpr (useFastSaturation)
+        {
+            dx = gain * fastTanh (drive * inputValue);
+            a  = dx + scaledResonanceValue * T (-4) * (gain2 * fastTanh (drive2 * s[4]) - dx * comp);
+        }
+        else
+        {
+            dx = gain * saturationLUT (drive * inputValue);
+            a  = dx + scaledResonanceValue * T (-4) * (gain2 * saturationLUT (drive2 * s[4]) - dx * comp);
+        }
+
+        const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+        const auto c = b1 * s[1] + a1 * s[2] + b0 * b;
+        const auto d = b1 * s[2] + a1 * s[3] + b0 * c;
+        const auto e = b1 * s[3] + a1 * s[4] + b0 * d;
+
+        s[0] = a;
+        s[1] = b;
+        s[2] = c;
+        s[3] = d;
+        s[4] = e;
+
+        return a * A[0] + b * A[1] + c * A[2] + d * A[3] + e * A[4];
+    }
+
+    void updateSmoothers() noexcept
+    {
+        cutoffTransformValue = cutoffTransformSmoother.getNextValue();
+        scaledResonanceValue = scaledResonanceSmoother.getNextValue();
+    }
+
+    /** A [3/2] padé approximation of tanh, which reaches exactly +-1 at +-3 and is clamped after that. */
+    static T fastTanh (T x) noexcept
+    {
+        const auto clamped { juce::jlimit (T (-3), T (3), x) };
+        const auto x2 { clamped * clamped };
+        return clamped * (T (27) + x2) / (T (27) + T (9) * x2);
+    }
+
+    /** This is exp (-2 * pi * cutoff / sampleRate), which is what updateCutoffFreq() computes, but read from a table. */
+    T getCutoffTransform (T cutoff) const noexcept
+    {
+        return cutoffTransformLUT (cutoff * cutoffNormaliser);
+    }
+
+  private:
+    void setSampleRate (T newValue) noexcept
+    {
+        jassert (newValue > T (0));
+        cutoffFreqScaler = T (-2.0 * juce::MathConstants<double>::pi) / newValue;
+        cutoffNormaliser = -cutoffFreqScaler;
+
+        static constexpr T smootherRampTimeSec = T (0.05);
+        cutoffTransformSmoother.reset (newValue, smootherRampTimeSec);
+        scaledResonanceSmoother.reset (newValue, smootherRampTimeSec);
+
+        updateCutoffFreq();
+    }
+
+    void setNumChannels (size_t newValue) { state.resize (newValue); }
+    void updateCutoffFreq() noexcept { cutoffTransformSmoother.setTargetValue (std::exp (cutoffFreqHz * cutoffFreqScaler)); }
+    void updateResonance() noexcept { scaledResonanceSmoother.setTargetValue (juce::jmap (resonance, T (0.1), T (1.0))); }
+
+    T drive, drive2, gain, gain2, comp;
+
+    static constexpr size_t                   numStates = 5;
+    std::vector<std::array<T, numStates>>     state;
+    std::array<T, numStates>                  A;
+
+    juce::SmoothedValue<T> cutoffTransformSmoother, scaledResonanceSmoother;
+    T                      cutoffTransformValue, scaledResonanceValue;
+
+    juce::dsp::LookupTableTransform<T> saturationLUT { [] (T x) { return std::tanh (x); }, T (-5), T (5), 128 };
+
+    //the normalised cutoff only goes up to nyquist. Above that, the table clamps its input
+    juce::dsp::LookupTableTransform<T> cutoffTransformLUT { [] (T w) { return std::exp (-w); }, T (0), juce::MathConstants<T>::pi, 512 };
+
+    T cutoffFreqHz { T (200) };
+    T resonance;
+
+    T cutoffFreqScaler;
+    T cutoffNormaliser;
+
+    Mode mode;
+    bool enabled = true;
+};
@@ -102,7 +102,9 @@ public:
 
     void updateOscLevels ()
     {
-        sub.setGain (curVelocity * curSubLevel);
+        //the sub used to be a separate oscillator summed into osc1's block before osc1's gain was applied to it,
+        //so it was scaled by velocity twice and by osc1's mix. Keep that scaling so existing presets sound the same
+        osc1.setSubOctaveGain (curVelocity * curVelocity * curSubLevel * (1 - oscMix));
         noise.setGain (curVelocity * curNoiseLevel);
         osc1.setGain (curVelocity * (1 - oscMix));
         osc2.setGain (curVelocity * oscMix);
@@ -128,7 +130,8 @@ private:
     juce::HeapBlock<char> heapBlock1, heapBlock2, heapBlockNoise;
 
     juce::dsp::AudioBlock<T> osc1Block, osc2Block, noiseBlock, osc1Output, osc2Output, noiseOutput;
-    GainedOscillator<T> sub, osc1, osc2, noise;
+    //the sub octave is rendered by osc1, from its own phase
+    GainedOscillator<T> osc1, osc2, noise;
 
     float osc1NoteOffset, osc2NoteOffset;
 
@@ -164,7 +167,6 @@ PhatOscillators<T>::PhatOscillators (juce::AudioProcessorValueTreeState& process
 {
     addParamListenersToState ();
 
-    sub.setOscShape (OscShape::pulse);
     noise.setOscShape (OscShape::noise);
 }
 
@@ -225,7 +227,6 @@ void PhatOscillators<T>::prepare (const juce::dsp::ProcessSpec& spec)
     osc2Block  = juce::dsp::AudioBlock<T> (heapBlock2, spec.numChannels, spec.maximumBlockSize);
     noiseBlock = juce::dsp::AudioBlock<T> (heapBlockNoise, spec.numChannels, spec.maximumBlockSize);
 
-    sub.prepare (spec);
     noise.prepare (spec);
     osc1.prepare (spec);
     osc2.prepare (spec);
@@ -252,8 +253,7 @@ juce::dsp::AudioBlock<T> PhatOscillators<T>::process (int pos, int subBlockSize)
     //process osc1
     auto block1 { osc1Output.getSubBlock ((size_t) pos, (size_t) subBlockSize) };
     juce::dsp::ProcessContextReplacing<T> osc1Context (block1);
-    sub.process (osc1Context); //TODO: is the sub on osc1 because that's how it is on the real prophet? Should it be added to the noise below instead?
-    osc1.process (osc1Context);
+    osc1.process (osc1Context); //this also renders the sub, which is derived from osc1's phase like on the real prophet
 
     //process osc2
     auto block2 { osc2Output.getSubBlock ((size_t) pos, (size_t) subBlockSize) };
@@ -287,10 +287,9 @@ void PhatOscillators<T>::updateOscFrequenciesInternal ()
     const auto curOsc1Slop = slopOsc1 * slopMod;
     const auto curOsc2Slop = slopOsc2 * slopMod;
 
-    const auto osc1FloatNote = static_cast<float> (curMidiNote) - osc1NoteOffset + osc1TuningOffset + lfoOsc1NoteOffset + pitchWheelDeltaNote + curOsc1Slop;
-    sub.setFrequency   (Helpers::getMidiNoteInHertz (osc1FloatNote - 12), true);
-    noise.setFrequency (Helpers::getMidiNoteInHertz (osc1FloatNote), true);
-    osc1.setFrequency  (Helpers::getMidiNoteInHertz (osc1FloatNote), true);
+    const auto osc1Freq = Helpers::getMidiNoteInHertz (static_cast<float> (curMidiNote) - osc1NoteOffset + osc1TuningOffset + lfoOsc1NoteOffset + pitchWheelDeltaNote + curOsc1Slop);
+    noise.setFrequency (osc1Freq, true);
+    osc1.setFrequency  (osc1Freq, true);
 
     const auto osc2Freq = Helpers::getMidiNoteInHertz (static_cast<float> (curMidiNote) - osc2NoteOffset + osc2TuningOffset + lfoOsc2NoteOffset + pitchWheelDeltaNote + curOsc2Slop);
     osc2.setFrequency (osc2Freq, true);
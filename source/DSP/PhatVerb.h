@@ -12,7 +12,8 @@ struct PhatVerbParameters
     T freezeMode = static_cast<T> (0);    /**< Freeze mode - values < 0.5 are "normal" mode, values > 0.5 put the reverb into a continuous feedback loop. */
 };
 
-//these are copied over from juce in order to support double-precision processing.
+//these are copied over from juce in order to support double-precision processing. The combs and allpasses
+//were then reorganised so that they can be vectorised: see processCombs() and AllPassFilter::process().
 template <std::floating_point T>
 class PhatVerb
 {
@@ -45,6 +46,17 @@ class PhatVerb
         updateDamping();
     }
 
+    /** Returns how long the reverb takes to decay by 60 dB, or infinity when it's frozen. */
+    double getTailLengthSeconds() const noexcept
+    {
+        if (isFrozen (parameters.freezeMode))
+            return std::numeric_limits<double>::infinity();
+
+        // every trip around a comb multiplies it by the feedback, and the longest comb is the slowest to decay
+        const auto longestCombSeconds { 1640. / 44100. };
+        return -3. * longestCombSeconds / std::log10 ((double) feedback.getTargetValue());
+    }
+
     /** Sets the sample rate that will be used for the reverb.
         You must call this before the process methods, in order to tell it the correct sample rate.
     */
@@ -59,16 +71,26 @@ class PhatVerb
 
         for (int i = 0; i < numCombs; ++i)
         {
-            comb[0][i].setSize ((intSampleRate * combTunings[i]) / 44100);
-            comb[1][i].setSize ((intSampleRate * (combTunings[i] + stereoSpread)) / 44100);
+            combDelays[(size_t) i]            = (intSampleRate * combTunings[i]) / 44100;
+            combDelays[(size_t) i + numCombs] = (intSampleRate * (combTunings[i] + stereoSpread)) / 44100;
         }
 
+        const auto combCapacity { juce::nextPowerOfTwo (*std::max_element (combDelays.begin(), combDelays.end())) };
+        combBuffer.malloc ((size_t) combCapacity * numCombLanes);
+        combMask     = combCapacity - 1;
+        combWritePos = 0;
+
         for (int i = 0; i < numAllPasses; ++i)
         {
             allPass[0][i].setSize ((intSampleRate * allPassTunings[i]) / 44100);
             allPass[1][i].setSize ((intSampleRate * (allPassTunings[i] + stereoSpread)) / 44100);
         }
 
+        // the shortest allpass needs to be at least a chunk long, see AllPassFilter::process()
+        jassert ((intSampleRate * allPassTunings[numAllPasses - 1]) / 44100 >= chunkSize);
+
+        reset();
+
         const double smoothTime = 0.01;
         damping.reset (sampleRate, smoothTime);
         feedback.reset (sampleRate, smoothTime);
@@ -80,14 +102,12 @@ class PhatVerb
     /** Clears the reverb's buffers. */
     void reset()
     {
-        for (int j = 0; j < numChannels; ++j)
-        {
-            for (int i = 0; i < numCombs; ++i)
-                comb[j][i].clear();
+        combBuffer.clear ((size_t) (combMask + 1) * numCombLanes);
+        combLast.fill (0);
 
+        for (int j = 0; j < numChannels; ++j)
             for (int i = 0; i < numAllPasses; ++i)
                 allPass[j][i].clear();
-        }
     }
 
     /** Applies the reverb to two stereo channels of audio data. */
@@ -96,33 +116,46 @@ class PhatVerb
         JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
         jassert (left != nullptr && right != nullptr);
 
-        for (int i = 0; i < numSamples; ++i)
+        const juce::ScopedNoDenormals noDenormals;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
         {
-            // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
-            const T input = (left[i] + right[i]) * gain;
-            T       outL = 0, outR = 0;
+            const auto curChunkSize { juce::jmin ((int) chunkSize, numSamples - start) };
+            auto* const chunkLeft { left + start };
+            auto* const chunkRight { right + start };
 
-            const T damp    = damping.getNextValue();
-            const T feedbck = feedback.getNextValue();
+            // damping and feedback are smoothed once per chunk rather than once per sample
+            const T damp    = damping.skip (curChunkSize);
+            const T feedbck = feedback.skip (curChunkSize);
 
-            for (int j = 0; j < numCombs; ++j) // accumulate the comb filters in parallel
+            for (int i = 0; i < curChunkSize; ++i) // accumulate the comb filters in parallel
             {
-                outL += comb[0][j].process (input, damp, feedbck);
-                outR += comb[1][j].process (input, damp, feedbck);
+                // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
+                const T input = (chunkLeft[i] + chunkRight[i]) * gain;
+                const auto& out { processCombs<numCombLanes> (input, damp, feedbck) };
+
+                wetL[(size_t) i] = sumLanes (out.data());
+                wetR[(size_t) i] = sumLanes (out.data() + numCombs);
             }
 
             for (int j = 0; j < numAllPasses; ++j) // run the allpass filters in series
             {
-                outL = allPass[0][j].process (outL);
-                outR = allPass[1][j].process (outR);
+                allPass[0][j].process (wetL.data(), curChunkSize);
+                allPass[1][j].process (wetR.data(), curChunkSize);
             }
 
-            const T dry  = dryGain.getNextValue();
-            const T wet1 = wetGain1.getNextValue();
-            const T wet2 = wetGain2.getNextValue();
+            for (int i = 0; i < curChunkSize; ++i)
+            {
+                const T dry  = dryGain.getNextValue();
+                const T wet1 = wetGain1.getNextValue();
+                const T wet2 = wetGain2.getNextValue();
 
-            left[i]  = outL * wet1 + outR * wet2 + left[i] * dry;
-            right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
+                const T outL = wetL[(size_t) i];
+                const T outR = wetR[(size_t) i];
+
+                chunkLeft[i]  = outL * wet1 + outR * wet2 + chunkLeft[i] * dry;
+                chunkRight[i] = outR * wet1 + outL * wet2 + chunkRight[i] * dry;
+            }
         }
         JUCE_END_IGNORE_WARNINGS_MSVC
     }
@@ -133,24 +166,29 @@ class PhatVerb
         JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
         jassert (samples != nullptr);
 
-        for (int i = 0; i < numSamples; ++i)
+        const juce::ScopedNoDenormals noDenormals;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
         {
-            const T input  = samples[i] * gain;
-            T       output = 0;
+            const auto curChunkSize { juce::jmin ((int) chunkSize, numSamples - start) };
+            auto* const chunk { samples + start };
 
-            const T damp    = damping.getNextValue();
-            const T feedbck = feedback.getNextValue();
+            const T damp    = damping.skip (curChunkSize);
+            const T feedbck = feedback.skip (curChunkSize);
 
-            for (int j = 0; j < numCombs; ++j) // accumulate the comb filters in parallel
-                output += comb[0][j].process (input, damp, feedbck);
+            for (int i = 0; i < curChunkSize; ++i) // accumulate the left comb filters in parallel
+                wetL[(size_t) i] = sumLanes (processCombs<numCombs> (chunk[i] * gain, damp, feedbck).data());
 
             for (int j = 0; j < numAllPasses; ++j) // run the allpass filters in series
-                output = allPass[0][j].process (output);
+                allPass[0][j].process (wetL.data(), curChunkSize);
 
-            const T dry  = dryGain.getNextValue();
-            const T wet1 = wetGain1.getNextValue();
+            for (int i = 0; i < curChunkSize; ++i)
+            {
+                const T dry  = dryGain.getNextValue();
+                const T wet1 = wetGain1.getNextValue();
 
-            samples[i] = output * wet1 + samples[i] * dry;
+                chunk[i] = wetL[(size_t) i] * wet1 + chunk[i] * dry;
+            }
         }
         JUCE_END_IGNORE_WARNINGS_MSVC
     }
@@ -177,49 +215,46 @@ class PhatVerb
         feedback.setTargetValue (roomSizeToUse);
     }
 
-    class CombFilter
+    enum
     {
-      public:
-        CombFilter() noexcept {}
+        numCombs     = 8,
+        numAllPasses = 4,
+        numChannels  = 2,
+        numCombLanes = numChannels * numCombs,
 
-        void setSize (const int size)
-        {
-            if (size != bufferSize)
-            {
-                bufferIndex = 0;
-                buffer.malloc (size);
-                bufferSize = size;
-            }
+        // the allpasses process a whole chunk at once, which works as long as no chunk is longer than their delay
+        chunkSize    = 32
+    };
 
-            clear();
-        }
+    /** Runs one sample through the first numLanes comb filters, the left ones followed by the right ones.
+        All the combs share a single write position in an interleaved delay memory, so the writes for a
+        given sample are contiguous and the loops over lanes are straight vectorisable arithmetic.
+    */
+    template <int numLanes>
+    const std::array<T, numCombLanes>& processCombs (const T input, const T damp, const T feedbackLevel) noexcept
+    {
+        auto* const writeFrame { combBuffer.getData() + combWritePos * numCombLanes };
 
-        void clear() noexcept
-        {
-            last = 0;
-            buffer.clear ((size_t) bufferSize);
-        }
+        for (int l = 0; l < numLanes; ++l)
+            combOut[(size_t) l] = combBuffer[((combWritePos - combDelays[(size_t) l]) & combMask) * numCombLanes + l];
 
-        T process (const T input, const T damp, const T feedbackLevel) noexcept
+        for (int l = 0; l < numLanes; ++l)
         {
-            const T output = buffer[bufferIndex];
-            last           = (output * (1.0f - damp)) + (last * damp);
-            JUCE_UNDENORMALISE (last);
-
-            T temp = input + (last * feedbackLevel);
-            JUCE_UNDENORMALISE (temp);
-            buffer[bufferIndex] = temp;
-            bufferIndex         = (bufferIndex + 1) % bufferSize;
-            return output;
+            combLast[(size_t) l] = combOut[(size_t) l] * (1 - damp) + combLast[(size_t) l] * damp;
+            writeFrame[l]        = input + combLast[(size_t) l] * feedbackLevel;
         }
 
-      private:
-        juce::HeapBlock<T> buffer;
-        int                bufferSize = 0, bufferIndex = 0;
-        T                  last = 0.0f;
+        combWritePos = (combWritePos + 1) & combMask;
+        return combOut;
+    }
 
-        JUCE_DECLARE_NON_COPYABLE (CombFilter)
-    };
+    static T sumLanes (const T* lanes) noexcept
+    {
+        T sum = 0;
+        for (int l = 0; l < numCombs; ++l)
+            sum += lanes[l];
+        return sum;
+    }
 
     class AllPassFilter
     {
@@ -228,51 +263,64 @@ class PhatVerb
 
         void setSize (const int size)
         {
-            if (size != bufferSize)
+            const auto capacity { juce::nextPowerOfTwo (size) };
+
+            if (capacity != mask + 1)
             {
-                bufferIndex = 0;
-                buffer.malloc (size);
-                bufferSize = size;
+                buffer.malloc (capacity);
+                mask = capacity - 1;
             }
 
+            bufferSize = size;
+            writeIndex = 0;
             clear();
         }
 
         void clear() noexcept
         {
-            buffer.clear ((size_t) bufferSize);
+            buffer.clear ((size_t) mask + 1);
         }
 
-        T process (const T input) noexcept
+        /** Processes numSamples in place. Since numSamples is never longer than the delay, everything we
+            read here was written by a previous call, so each loop below has no dependency between samples.
+        */
+        void process (T* const samples, const int numSamples) noexcept
         {
-            const T bufferedValue = buffer[bufferIndex];
-            T       temp          = input + (bufferedValue * 0.5f);
-            JUCE_UNDENORMALISE (temp);
-            buffer[bufferIndex] = temp;
-            bufferIndex         = (bufferIndex + 1) % bufferSize;
-            return bufferedValue - input;
+            jassert (numSamples <= bufferSize && numSamples <= chunkSize);
+
+            std::array<T, chunkSize> delayed;
+            for (int i = 0; i < numSamples; ++i)
+                delayed[(size_t) i] = buffer[(writeIndex + i - bufferSize) & mask];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                buffer[(writeIndex + i) & mask] = samples[i] + delayed[(size_t) i] * T (0.5);
+                samples[i]                      = delayed[(size_t) i] - samples[i];
+            }
+
+            writeIndex = (writeIndex + numSamples) & mask;
         }
 
       private:
         juce::HeapBlock<T> buffer;
-        int                bufferSize = 0, bufferIndex = 0;
+        int                bufferSize = 0, writeIndex = 0, mask = -1;
 
         JUCE_DECLARE_NON_COPYABLE (AllPassFilter)
     };
 
-    enum
-    {
-        numCombs     = 8,
-        numAllPasses = 4,
-        numChannels  = 2
-    };
-
     PhatVerbParameters<T> parameters;
     T                     gain;
 
-    CombFilter    comb[numChannels][numCombs];
+    juce::HeapBlock<T>                       combBuffer;
+    int                                      combMask = 0, combWritePos = 0;
+    std::array<int, numCombLanes>            combDelays {};
+    alignas (32) std::array<T, numCombLanes> combLast {}, combOut {};
+
     AllPassFilter allPass[numChannels][numAllPasses];
 
+    // comb output for the current chunk, that then goes through the allpasses
+    std::array<T, chunkSize> wetL {}, wetR {};
+
     juce::SmoothedValue<T> damping, feedback, dryGain, wetGain1, wetGain2;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhatVerb)
@@ -280,7 +328,8 @@ class PhatVerb
 
 //==============================================================================
 
-template <std::floating_point T>
+/** Wraps PhatVerb, or any reverb with the same interface like PhatFdnVerb, into a juce::dsp style processor. */
+template <std::floating_point T, typename ReverbType = PhatVerb<T>>
 class PhatVerbProcessor
 {
   public:
@@ -296,6 +345,9 @@ class PhatVerbProcessor
     */
     void setParameters (const PhatVerbParameters<T>& newParams) { reverb.setParameters (newParams); }
 
+    /** Returns how long the reverb keeps ringing after its input goes silent. */
+    double getTailLengthSeconds() const noexcept { return reverb.getTailLengthSeconds(); }
+
     /** Returns true if the reverb is enabled. */
     bool isEnabled() const noexcept { return enabled; }
 
@@ -347,6 +399,6 @@ class PhatVerbProcessor
     }
 
   private:
-    PhatVerb<T> reverb;
-    bool        enabled = true;
+    ReverbType reverb;
+    bool       enabled = true;
 };
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PhatLadderFilter.h"
+
+/**
+ * @brief A linear, 12 dB/octave low-pass state variable filter (topology-preserving transform, as described by
+    Zavalishin and Simper). It has no saturation and only 2 states per channel, which makes it our cheapest filter.
+    Like PhatLadderFilter, it takes one cutoff value per sample and gets its coefficient from a lookup table.
+*/
+template <std::floating_point T>
+class PhatSvfFilter
+{
+  public:
+    PhatSvfFilter()
+        : state (2)
+    {
+        setSampleRate (T (1000)); // intentionally setting unrealistic default sample rate to catch missing initialisation bugs
+        setResonance (T (0));
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        setSampleRate (T (spec.sampleRate));
+        state.resize (spec.numChannels);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& s : state)
+            s.fill (T (0));
+
+        resonanceSmoother.setCurrentAndTargetValue (resonanceSmoother.getTargetValue());
+    }
+
+    /** Sets the resonance of the filter. @param newResonance a value between 0 and 1 */
+    void setResonance (T newResonance) noexcept
+    {
+        jassert (newResonance >= T (0) && newResonance <= T (1));
+
+        //k is 1/Q. We stop a bit before 0 so the filter never self-oscillates
+        resonanceSmoother.setTargetValue (T (2) - T (2) * maxResonance * newResonance);
+    }
+
+    /** Filters the block in place, using cutoffHz[n] as the cutoff frequency for sample n. */
+    void process (const juce::dsp::AudioBlock<T>& block, const T* cutoffHz) noexcept
+    {
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = block.getNumSamples();
+
+        jassert (numChannels <= state.size());
+        jassert (cutoffHz != nullptr);
+
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            const auto g  = tanLUT (cutoffHz[n] * cutoffNormaliser);
+            const auto k  = resonanceSmoother.getNextValue();
+            const auto a1 = T (1) / (T (1) + g * (g + k));
+            const auto a2 = g * a1;
+            const auto a3 = g * a2;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto& s       = state[ch];
+                auto* channel = block.getChannelPointer (ch);
+
+                const auto v3 = channel[n] - s[1];
+                const auto v1 = a1 * s[0] + a2 * v3;
+                const auto v2 = s[1] + a2 * s[0] + a3 * v3;
+
+                s[0] = T (2) * v1 - s[0];
+                s[1] = T (2) * v2 - s[1];
+
+                channel[n] = v2;
+            }
+        }
+    }
+
+  private:
+    void setSampleRate (T newValue) noexcept
+    {
+        jassert (newValue > T (0));
+        cutoffNormaliser = juce::MathConstants<T>::pi / newValue;
+        resonanceSmoother.reset (newValue, T (0.05));
+    }
+
+    static constexpr auto maxResonance { T (0.98) };
+
+    //the table stops at 90% of nyquist, because tan() blows up after that
+    juce::dsp::LookupTableTransform<T> tanLUT { [] (T w) { return std::tan (w); }, T (0), T (0.45) * juce::MathConstants<T>::pi, 512 };
+
+    std::vector<std::array<T, 2>> state;
+    juce::SmoothedValue<T>        resonanceSmoother;
+    T                             cutoffNormaliser;
+};
+
+//==============================================================================
+
+/**
+ * @brief The filter used by each voice, which lets us trade character for CPU, per instance.
+    All models are low-pass 12 dB/octave and take one cutoff per sample. CPU cost per voice (stereo), per sample:
+     - FilterModel::eco:      linear PhatSvfFilter, no saturation.                                       ~15 ns (0.07% of a core)
+     - FilterModel::standard: the ladder, with a padé tanh on its input and feedback path.               ~43 ns (0.21% of a core)
+     - FilterModel::analog:   the full ladder, same as juce::dsp::LadderFilter, with table tanh instead. ~49 ns (0.24% of a core)
+    Measured with the PhatVoiceFilter kernel of "Kernel performance" in benchmarks/KernelBenchmarks.cpp (48 kHz,
+    512-sample blocks, 200 to 8200 Hz cutoff sweep, resonance .7, best of 15 runs), built with g++ 12 -O3 -ffast-math
+    on a 2 GHz Xeon VM. The % is of one core at 48 kHz. The padé's divisions cost about as much as the table reads,
+    so standard is only a bit cheaper than analog; eco is where the savings are.
+
+    Switching models crossfades from the old one to the new one over modelCrossfadeSeconds, so it doesn't click.
+*/
+template <std::floating_point T>
+class PhatVoiceFilter
+{
+  public:
+    PhatVoiceFilter() = default;
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        svf.prepare (spec);
+        fastLadder.prepare (spec);
+        ladder.prepare (spec);
+
+        prevModelBuffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        prevModelGain.reset (spec.sampleRate, modelCrossfadeSeconds);
+    }
+
+    void reset() noexcept
+    {
+        svf.reset();
+        fastLadder.reset();
+        ladder.reset();
+
+        prevModelGain.setCurrentAndTargetValue (T (0));
+    }
+
+    /** This can be called from any thread, the model actually changes at the start of the next process() call. */
+    void setModel (FilterModel::Values newModel) noexcept { requestedModel.store (newModel); }
+
+    FilterModel::Values getModel() const noexcept { return requestedModel.load(); }
+
+    void setResonance (T newResonance) noexcept
+    {
+        svf.setResonance (newResonance);
+        fastLadder.setResonance (newResonance);
+        ladder.setResonance (newResonance);
+    }
+
+    void process (const juce::dsp::AudioBlock<T>& block, const T* cutoffHz) noexcept
+    {
+        //a model that isn't processed keeps whatever it had left, so we clear the new one when we switch to it.
+        //Requests that come in mid-crossfade wait for it to be done
+        if (const auto newModel { requestedModel.load() }; newModel != curModel && ! prevModelGain.isSmoothing())
+        {
+            prevModel = std::exchange (curModel, newModel);
+            resetModel (curModel);
+
+            prevModelGain.setCurrentAndTargetValue (T (1));
+            prevModelGain.setTargetValue (T (0));
+        }
+
+        if (! prevModelGain.isSmoothing())
+        {
+            processModel (curModel, block, cutoffHz);
+            return;
+        }
+
+        //the previous model gets a copy of the input, and the current one processes the input in place
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples  = block.getNumSamples();
+        jassert (prevModelBuffer.getNumChannels() >= (int) numChannels && prevModelBuffer.getNumSamples() >= (int) numSamples);
+
+        auto prevBlock { juce::dsp::AudioBlock<T> (prevModelBuffer).getSubBlock (0, numSamples).getSubsetChannelBlock (0, numChannels) };
+        prevBlock.copyFrom (block);
+
+        processModel (prevModel, prevBlock, cutoffHz);
+        processModel (curModel, block, cutoffHz);
+
+        //out = cur * (1 - gain) + prev * gain = cur + (prev - cur) * gain
+        for (size_t n = 0; n < numSamples; ++n)
+        {
+            const auto g = prevModelGain.getNextValue();
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto* channel = block.getChannelPointer (ch);
+                channel[n] += (prevBlock.getChannelPointer (ch)[n] - channel[n]) * g;
+            }
+        }
+    }
+
+  private:
+    void processModel (FilterModel::Values model, const juce::dsp::AudioBlock<T>& block, const T* cutoffHz) noexcept
+    {
+        switch (model)
+        {
+            case FilterModel::eco:      svf.process (block, cutoffHz); break;
+            case FilterModel::standard: fastLadder.process (block, cutoffHz); break;
+            case FilterModel::analog:   ladder.process (block, cutoffHz); break;
+            default: jassertfalse; break;
+        }
+    }
+
+    void resetModel (FilterModel::Values model) noexcept
+    {
+        switch (model)
+        {
+            case FilterModel::eco:      svf.reset(); break;
+            case FilterModel::standard: fastLadder.reset(); break;
+            case FilterModel::analog:   ladder.reset(); break;
+            default: jassertfalse; break;
+        }
+    }
+
+    static constexpr auto modelCrossfadeSeconds { .01 };
+
+    PhatSvfFilter<T>          svf;
+    PhatLadderFilter<T, true> fastLadder;
+    PhatLadderFilter<T>       ladder;
+
+    std::atomic<FilterModel::Values> requestedModel { FilterModel::analog };
+    FilterModel::Values              curModel { FilterModel::analog };
+    FilterModel::Values              prevModel { FilterModel::analog };
+
+    //the previous model's gain while we crossfade, and where it renders
+    juce::SmoothedValue<T, juce::ValueSmoothingTypes::Linear> prevModelGain;
+    juce::AudioBuffer<T>                                      prevModelBuffer;
+};
@@ -83,10 +83,15 @@ ProPhatProcessor::ProPhatProcessor()
     , state { constructState () }
     , proPhatSynthFloat (state)
     , proPhatSynthDouble (state)
-#if CPU_USAGE
-    , perfCounter ("ProcessBlock")
-#endif
 {
+    proPhatSynthFloat.setProfiler (&profiler);
+    proPhatSynthDouble.setProfiler (&profiler);
+
+#if ENABLE_TRACE_LOG
+    //maps the trace file here, rather than on the audio thread the first time we trace something
+    TraceLog::getInstance();
+#endif
+
 #if TEST_SIMD
     Vector a(17, 1.f);
     auto result = simdAdd (a, a);
@@ -97,6 +102,8 @@ ProPhatProcessor::ProPhatProcessor()
 
 void ProPhatProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    deadlineMonitor.prepare (sampleRate);
+
     if (isUsingDoublePrecision())
         proPhatSynthDouble.prepare ({ sampleRate, (juce::uint32) samplesPerBlock, 2 });
     else
@@ -136,11 +143,13 @@ juce::AudioProcessorValueTreeState ProPhatProcessor::constructState ()
 
         std::make_unique<juce::AudioParameterFloat>  (filterCutoffID, filterCutoffID.getParamID (), cutOffRange, defaultFilterCutoff),
         std::make_unique<juce::AudioParameterFloat>  (filterResonanceID, filterResonanceID.getParamID (), sliderRange, defaultFilterResonance),
+        std::make_unique<juce::AudioParameterChoice> (filterModelID, filterModelID.getParamID (), juce::StringArray { filterModel0, filterModel1, filterModel2 }, defaultFilterModel),
 
         std::make_unique<juce::AudioParameterFloat>  (ampAttackID, ampAttackID.getParamID (), attackRange, defaultAmpA),
         std::make_unique<juce::AudioParameterFloat>  (ampDecayID, ampDecayID.getParamID (), decayRange, defaultAmpD),
         std::make_unique<juce::AudioParameterFloat>  (ampSustainID, ampSustainID.getParamID (), sustainRange, defaultAmpS),
         std::make_unique<juce::AudioParameterFloat>  (ampReleaseID, ampReleaseID.getParamID (), releaseRange, defaultAmpR),
+        std::make_unique<juce::AudioParameterBool>   (voiceRetriggerID, voiceRetriggerID.getParamID (), defaultVoiceRetrigger),
 
         std::make_unique<juce::AudioParameterFloat>  (filterEnvAttackID, filterEnvAttackID.getParamID (), attackRange, defaultAmpA),
         std::make_unique<juce::AudioParameterFloat>  (filterEnvDecayID, filterEnvDecayID.getParamID (), decayRange, defaultAmpD),
@@ -159,6 +168,15 @@ juce::AudioProcessorValueTreeState ProPhatProcessor::constructState ()
         std::make_unique<juce::AudioParameterFloat>  (phaserParam1ID, phaserParam1ID.getParamID (), sliderRange, defaultEffectParam1),
         std::make_unique<juce::AudioParameterFloat>  (phaserParam2ID, phaserParam2ID.getParamID (), sliderRange, defaultEffectParam2),
         std::make_unique<juce::AudioParameterChoice> (effectSelectedID, effectSelectedID.getParamID (), juce::StringArray { effect0, effect1, effect2, effect3 }, defaultLfoShape),
+        std::make_unique<juce::AudioParameterChoice> (effectSlot2ID, effectSlot2ID.getParamID (), juce::StringArray { effect0, effect1, effect2, effect3 }, defaultEffect),
+        std::make_unique<juce::AudioParameterChoice> (effectSlot3ID, effectSlot3ID.getParamID (), juce::StringArray { effect0, effect1, effect2, effect3 }, defaultEffect),
+        std::make_unique<juce::AudioParameterBool>   (effectSlot1BypassID, effectSlot1BypassID.getParamID (), false),
+        std::make_unique<juce::AudioParameterBool>   (effectSlot2BypassID, effectSlot2BypassID.getParamID (), false),
+        std::make_unique<juce::AudioParameterBool>   (effectSlot3BypassID, effectSlot3BypassID.getParamID (), false),
+        std::make_unique<juce::AudioParameterFloat>  (effectSlot1MixID, effectSlot1MixID.getParamID (), sliderRange, defaultEffectSlotMix),
+        std::make_unique<juce::AudioParameterFloat>  (effectSlot2MixID, effectSlot2MixID.getParamID (), sliderRange, defaultEffectSlotMix),
+        std::make_unique<juce::AudioParameterFloat>  (effectSlot3MixID, effectSlot3MixID.getParamID (), sliderRange, defaultEffectSlotMix),
+        std::make_unique<juce::AudioParameterChoice> (reverbAlgorithmID, reverbAlgorithmID.getParamID (), juce::StringArray { reverbAlgorithm0, reverbAlgorithm1, reverbAlgorithm2 }, defaultReverbAlgorithm),
 
         std::make_unique<juce::AudioParameterFloat>  (masterGainID, masterGainID.getParamID (), sliderRange, defaultMasterGain)
     }};
@@ -199,9 +217,9 @@ void ProPhatProcessor::process (juce::AudioBuffer<T>& buffer, juce::MidiBuffer&
 {
     juce::ScopedNoDenormals noDenormals;
 
-#if CPU_USAGE
-    perfCounter.start ();
-#endif
+    const auto startTicks { juce::Time::getHighResolutionTicks() };
+    StageTimer timer { &profiler };
+    TRACE_EVENT (TraceEventType::processBlockBegin, -1, buffer.getNumSamples(), midiMessages.getNumEvents());
 
     //we're not dealing with any inputs here, so clear the buffer
     buffer.clear ();
@@ -221,9 +239,17 @@ void ProPhatProcessor::process (juce::AudioBuffer<T>& buffer, juce::MidiBuffer&
     else
         proPhatSynthFloat.renderNextBlock (buffer, midiMessages, 0, buffer.getNumSamples());
 
-#if CPU_USAGE
-    perfCounter.stop();
-#endif
+    static const auto silenceThreshold { juce::Decibels::decibelsToGain (static_cast<T> (Constants::outputSilenceThresholdDb)) };
+    outputSilent.store (buffer.getMagnitude (0, buffer.getNumSamples()) < silenceThreshold, std::memory_order_relaxed);
+
+    TRACE_EVENT (TraceEventType::processBlockEnd);
+    timer.lap (ProfilerStage::processBlock);
+    deadlineMonitor.recordBlock (juce::Time::getHighResolutionTicks() - startTicks, buffer.getNumSamples());
+}
+
+double ProPhatProcessor::getTailLengthSeconds() const
+{
+    return isUsingDoublePrecision() ? proPhatSynthDouble.getTailLengthSeconds() : proPhatSynthFloat.getTailLengthSeconds();
 }
 
 void ProPhatProcessor::getStateInformation (juce::MemoryBlock& destData)
@@ -24,6 +24,8 @@
 
 #include "../Utility/Macros.h"
 #include "ProPhatSynthesiser.h"
+#include "../Utility/DeadlineMonitor.h"
+#include "../Utility/StageProfiler.h"
 
 #define TRIGGER_RTSAN 0
 
@@ -59,7 +61,10 @@ public:
     bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
+
+    /** True when the last processed block was entirely under Constants::outputSilenceThresholdDb. */
+    bool isOutputSilent() const { return outputSilent.load (std::memory_order_relaxed); }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -76,9 +81,11 @@ public:
 
     juce::AudioProcessorValueTreeState state;
 
-#if CPU_USAGE
-    PerformanceCounter perfCounter;
-#endif
+    /** Always there, but only timing anything once enabled. Drained by the editor on the message thread. */
+    StageProfiler profiler;
+
+    /** How long each block took to render, relative to how long it lasts. Always on. */
+    DeadlineMonitor deadlineMonitor;
 
     struct MidiMessageListener
     {
@@ -94,6 +101,8 @@ private:
 
     juce::AudioProcessorValueTreeState constructState ();
 
+    std::atomic<bool> outputSilent { true };
+
 #if TRIGGER_RTSAN
     juce::CriticalSection processBlockLock;
 #endif
@@ -28,6 +28,8 @@
 #include "LockFreeSynthesiser.h"
 #include "ProPhatVoice.h"
 #include "../Utility/Helpers.h"
+#include "../Utility/StageProfiler.h"
+#include "../Utility/TraceLog.h"
 
 /** The main Synthesiser for the plugin. It uses Constants::numVoices voices (of type ProPhatVoice),
 *   and one ProPhatSound, which applies to all midi notes. It responds to paramater changes in the
@@ -49,16 +51,53 @@ class ProPhatSynthesiser : public LockFreeSynthesiser, public juce::AudioProcess
 
     void setMasterGain (float gain);
 
+    /** @brief Returns how long we keep making sound after the last note off: the amp release, plus whatever
+     *  the effects take to ring out. Called on the message thread.
+     */
+    double getTailLengthSeconds() const;
+
+    /** @brief Voices in their release phase get stopped as soon as their output level drops under thresholdDb. */
+    void setVoiceCullThreshold (float thresholdDb);
+
     void noteOn (const int midiChannel, const int midiNoteNumber, const float velocity) override;
 
+    /** @brief True when no voice is playing and the effect tails have died out, in which case we output
+     *  silence and only handle midi events until a voice starts again.
+     */
+    bool isIdle() const;
+
+    /** @brief Times midi dispatch, voices, effects and master gain into profiler, and hands it to all voices. Can be null. */
+    void setProfiler (StageProfiler* newProfiler);
+
   private:
     void renderVoices (juce::AudioBuffer<T>& outputAudio, int startSample, int numSamples) override;
 
+    /** Renders the voices and effects over at most Constants::renderQuantum samples. */
+    void renderChunk (juce::AudioBuffer<T>& outputAudio, int startSample, int numSamples, StageTimer& timer);
+
+    void handleMidiEvent (const juce::MidiMessage& m) override;
+
+    /** Swaps the stolen voice with a free ghost voice, and lets it fade out from the ghost pool. */
+    LockFreeSynthesiserVoice* handOffStolenVoice (LockFreeSynthesiserVoice* stolenVoice) override;
+
+    //spare voices that take the place of stolen voices, while those fade out in here
+    juce::OwnedArray<LockFreeSynthesiserVoice> ghostVoices;
+
     //TODO: make this into a bit mask thing?
     std::set<int> voicesBeingKilled;
 
 #if ! EFFECTS_PROCESSOR_PER_VOICE
     EffectsProcessor<T> effectsProcessor;
+
+    /** Returns the index of the effect slot whose parameter in slotIDs is parameterID, or -1. */
+    static int findEffectSlot (const std::array<juce::ParameterID, Constants::numEffectSlots>& slotIDs, const juce::String& parameterID)
+    {
+        for (size_t i = 0; i < slotIDs.size(); ++i)
+            if (parameterID == slotIDs[i].getParamID())
+                return (int) i;
+
+        return -1;
+    }
 #endif
 
     //TODO: probably don't need the wrapper on this
@@ -66,6 +105,18 @@ class ProPhatSynthesiser : public LockFreeSynthesiser, public juce::AudioProcess
 
     juce::AudioProcessorValueTreeState& state;
 
+    StageProfiler* profiler { nullptr };
+
+    //only used to report our tail length
+    std::atomic<float> ampReleaseSeconds { Constants::defaultAmpR };
+
+    //how many samples the effects output has been under Constants::outputSilenceThresholdDb
+    int silentTailSamples { 0 };
+    int idleHoldSamples { 0 };
+
+    //our render chunks end on multiples of Constants::renderQuantum, wherever the midi events split the block
+    int samplesToQuantumBoundary { Constants::renderQuantum };
+
     juce::dsp::ProcessSpec curSpecs;
 };
 
@@ -78,6 +129,9 @@ ProPhatSynthesiser<T>::ProPhatSynthesiser (juce::AudioProcessorValueTreeState& p
     for (auto i = 0; i < Constants::numVoices; ++i)
         addVoice (new ProPhatVoice<T> (state, i, &voicesBeingKilled));
 
+    for (auto i = 0; i < Constants::numGhostVoices; ++i)
+        ghostVoices.add (new ProPhatVoice<T> (state, Constants::numVoices + i, &voicesBeingKilled));
+
     addSound (new ProPhatSound());
 
     addParamListenersToState();
@@ -102,10 +156,19 @@ void ProPhatSynthesiser<T>::addParamListenersToState()
     state.addParameterListener (phaserParam1ID.getParamID(), this);
     state.addParameterListener (phaserParam2ID.getParamID(), this);
 
-    state.addParameterListener (effectSelectedID.getParamID(), this);
+    state.addParameterListener (reverbAlgorithmID.getParamID(), this);
+
+    for (auto i = 0; i < Constants::numEffectSlots; ++i)
+    {
+        state.addParameterListener (effectSlotTypeIDs[(size_t) i].getParamID(), this);
+        state.addParameterListener (effectSlotBypassIDs[(size_t) i].getParamID(), this);
+        state.addParameterListener (effectSlotMixIDs[(size_t) i].getParamID(), this);
+    }
 #endif
 
     state.addParameterListener (masterGainID.getParamID(), this);
+    state.addParameterListener (voiceRetriggerID.getParamID(), this);
+    state.addParameterListener (ampReleaseID.getParamID(), this);
 }
 
 template <std::floating_point T>
@@ -118,14 +181,29 @@ void ProPhatSynthesiser<T>::prepare (const juce::dsp::ProcessSpec& spec) noexcep
 
     setCurrentPlaybackSampleRate (spec.sampleRate);
 
+    idleHoldSamples = static_cast<int> (std::ceil (Constants::idleHoldSeconds * spec.sampleRate));
+    silentTailSamples = 0;
+    samplesToQuantumBoundary = Constants::renderQuantum;
+
+    //we never render more than a quantum at a time, so that's all the scratch space we need. Except that
+    //voices also render their kill ramp in one go when they get stolen
+    const auto quantumSpec { juce::dsp::ProcessSpec { spec.sampleRate, (juce::uint32) Constants::renderQuantum, spec.numChannels } };
+    const auto voiceSpec { juce::dsp::ProcessSpec { spec.sampleRate, (juce::uint32) juce::jmax (Constants::renderQuantum, Constants::killRampSamples), spec.numChannels } };
+
     for (auto* v : voices)
-        dynamic_cast<ProPhatVoice<T>*> (v)->prepare (spec);
+        dynamic_cast<ProPhatVoice<T>*> (v)->prepare (voiceSpec);
+
+    for (auto* v : ghostVoices)
+    {
+        v->setCurrentPlaybackSampleRate (spec.sampleRate);
+        dynamic_cast<ProPhatVoice<T>*> (v)->prepare (voiceSpec);
+    }
 
 #if ! EFFECTS_PROCESSOR_PER_VOICE
-    effectsProcessor.prepare (spec);
+    effectsProcessor.prepare (quantumSpec);
 #endif
 
-    gainWrapper->prepare (spec);
+    gainWrapper->prepare (quantumSpec);
 }
 
 template <std::floating_point T>
@@ -133,6 +211,9 @@ void ProPhatSynthesiser<T>::releaseResources()
 {
     for (auto* v : voices)
         dynamic_cast<ProPhatVoice<T>*> (v)->releaseResources();
+
+    for (auto* v : ghostVoices)
+        dynamic_cast<ProPhatVoice<T>*> (v)->releaseResources();
 }
 
 template <std::floating_point T>
@@ -144,13 +225,17 @@ void ProPhatSynthesiser<T>::parameterChanged (const juce::String& parameterID, f
 
     if (parameterID == masterGainID.getParamID ())
         setMasterGain (newValue);
+    else if (parameterID == voiceRetriggerID.getParamID ())
+        setVoiceRecyclingEnabled (newValue > .5f);
+    else if (parameterID == ampReleaseID.getParamID ())
+        ampReleaseSeconds = newValue;
 
 #if ! EFFECTS_PROCESSOR_PER_VOICE
     else if (parameterID == reverbParam1ID.getParamID() || parameterID == reverbParam2ID.getParamID()
         || parameterID == chorusParam1ID.getParamID() || parameterID == chorusParam2ID.getParamID()
         || parameterID == phaserParam1ID.getParamID() || parameterID == phaserParam2ID.getParamID())
         effectsProcessor.setEffectParam (parameterID, newValue);
-    else if (parameterID == effectSelectedID.getParamID())
+    else if (const auto slot { findEffectSlot (effectSlotTypeIDs, parameterID) }; slot >= 0)
     {
         const auto effect = [val = static_cast<int> (newValue)]() -> EffectType
         {
@@ -164,8 +249,14 @@ void ProPhatSynthesiser<T>::parameterChanged (const juce::String& parameterID, f
             }
         }();
 
-        effectsProcessor.changeEffect (effect);
+        effectsProcessor.changeEffect (slot, effect);
     }
+    else if (const auto bypassSlot { findEffectSlot (effectSlotBypassIDs, parameterID) }; bypassSlot >= 0)
+        effectsProcessor.setSlotBypassed (bypassSlot, newValue > .5f);
+    else if (const auto mixSlot { findEffectSlot (effectSlotMixIDs, parameterID) }; mixSlot >= 0)
+        effectsProcessor.setSlotMix (mixSlot, static_cast<T> (newValue));
+    else if (parameterID == reverbAlgorithmID.getParamID())
+        effectsProcessor.setReverbAlgorithm (static_cast<ReverbAlgorithm::Values> (newValue));
 #endif
     else
         jassertfalse;
@@ -177,6 +268,55 @@ void ProPhatSynthesiser<T>::setMasterGain (float gain)
     gainWrapper->processor.setGainLinear (static_cast<T> (gain));
 }
 
+template <std::floating_point T>
+double ProPhatSynthesiser<T>::getTailLengthSeconds() const
+{
+#if ! EFFECTS_PROCESSOR_PER_VOICE
+    return ampReleaseSeconds.load() + effectsProcessor.getTailLengthSeconds();
+#else
+    return ampReleaseSeconds.load();
+#endif
+}
+
+template <std::floating_point T>
+void ProPhatSynthesiser<T>::setVoiceCullThreshold (float thresholdDb)
+{
+    for (auto* v : voices)
+        dynamic_cast<ProPhatVoice<T>*> (v)->setCullThreshold (static_cast<T> (thresholdDb));
+
+    for (auto* v : ghostVoices)
+        dynamic_cast<ProPhatVoice<T>*> (v)->setCullThreshold (static_cast<T> (thresholdDb));
+}
+
+template <std::floating_point T>
+LockFreeSynthesiserVoice* ProPhatSynthesiser<T>::handOffStolenVoice (LockFreeSynthesiserVoice* stolenVoice)
+{
+    const auto voiceIndex { voices.indexOf (stolenVoice) };
+    if (voiceIndex < 0)
+        return stolenVoice;
+
+    [[maybe_unused]] const auto stolenVoiceId { dynamic_cast<ProPhatVoice<T>*> (stolenVoice)->getVoiceId() };
+
+    for (int i = 0; i < ghostVoices.size(); ++i)
+    {
+        auto* ghost = ghostVoices.getUnchecked (i);
+        if (ghost->isVoiceActive())
+            continue;
+
+        //swap the two voices without deleting either, the stolen one now fades out from the ghost pool
+        voices.set (voiceIndex, ghost, false);
+        ghostVoices.set (i, stolenVoice, false);
+        dynamic_cast<ProPhatVoice<T>*> (stolenVoice)->startFadeOut();
+
+        TRACE_EVENT (TraceEventType::voiceSteal, stolenVoiceId, dynamic_cast<ProPhatVoice<T>*> (ghost)->getVoiceId());
+        return ghost;
+    }
+
+    //no ghost slot available, fall back to the pre-rendered kill ramp
+    TRACE_EVENT (TraceEventType::voiceSteal, stolenVoiceId, -1);
+    return stolenVoice;
+}
+
 template <std::floating_point T>
 void ProPhatSynthesiser<T>::noteOn (const int midiChannel, const int midiNoteNumber, const float velocity)
 {
@@ -192,18 +332,95 @@ void ProPhatSynthesiser<T>::noteOn (const int midiChannel, const int midiNoteNum
 #endif
 }
 
+template <std::floating_point T>
+bool ProPhatSynthesiser<T>::isIdle() const
+{
+    const auto isActive = [] (const LockFreeSynthesiserVoice* voice) { return static_cast<const ProPhatVoice<T>*> (voice)->isRendering(); };
+
+    return silentTailSamples >= idleHoldSamples
+        && std::none_of (voices.begin(), voices.end(), isActive)
+        && std::none_of (ghostVoices.begin(), ghostVoices.end(), isActive);
+}
+
+template <std::floating_point T>
+void ProPhatSynthesiser<T>::setProfiler (StageProfiler* newProfiler)
+{
+    profiler = newProfiler;
+
+    for (auto* v : voices)
+        dynamic_cast<ProPhatVoice<T>*> (v)->setProfiler (newProfiler);
+
+    for (auto* v : ghostVoices)
+        dynamic_cast<ProPhatVoice<T>*> (v)->setProfiler (newProfiler);
+}
+
+template <std::floating_point T>
+void ProPhatSynthesiser<T>::handleMidiEvent (const juce::MidiMessage& m)
+{
+    StageTimer timer { profiler };
+
+#if ENABLE_TRACE_LOG
+    const auto* raw { m.getRawData() };
+    const auto size { m.getRawDataSize() };
+    TRACE_EVENT (TraceEventType::midiEvent, -1, raw[0], (size > 1 ? raw[1] : 0) | (size > 2 ? raw[2] << 8 : 0));
+#endif
+
+    LockFreeSynthesiser::handleMidiEvent (m);
+    timer.lap (ProfilerStage::midi);
+}
+
 template <std::floating_point T>
 void ProPhatSynthesiser<T>::renderVoices (juce::AudioBuffer<T>& outputAudio, int startSample, int numSamples)
 {
+    //the processor cleared the buffer already, so there's nothing to do until a note comes in
+    if (isIdle())
+        return;
+
+    //one timer over all chunks, so we record once per render call and not once per quantum
+    StageTimer timer { profiler };
+
+    while (numSamples > 0)
+    {
+        const auto chunkSize { juce::jmin (numSamples, samplesToQuantumBoundary) };
+        renderChunk (outputAudio, startSample, chunkSize, timer);
+
+        startSample += chunkSize;
+        numSamples -= chunkSize;
+
+        samplesToQuantumBoundary -= chunkSize;
+        if (samplesToQuantumBoundary == 0)
+            samplesToQuantumBoundary = Constants::renderQuantum;
+    }
+}
+
+template <std::floating_point T>
+void ProPhatSynthesiser<T>::renderChunk (juce::AudioBuffer<T>& outputAudio, int startSample, int numSamples, StageTimer& timer)
+{
+    jassert (numSamples <= Constants::renderQuantum);
+
     for (auto* voice : voices)
         voice->renderNextBlock (outputAudio, startSample, numSamples);
 
+    for (auto* voice : ghostVoices)
+        voice->renderNextBlock (outputAudio, startSample, numSamples);
+
+    timer.lap (ProfilerStage::voices);
+
     auto audioBlock { juce::dsp::AudioBlock<T> (outputAudio).getSubBlock ((size_t) startSample, (size_t) numSamples) };
     const auto context { juce::dsp::ProcessContextReplacing<T> (audioBlock) };
 
 #if ! EFFECTS_PROCESSOR_PER_VOICE
     effectsProcessor.process (context);
+    timer.lap (ProfilerStage::effects);
 #endif
 
+    //measured before the master gain, so that turning the volume down doesn't cut the tails short
+    static const auto silenceThreshold { juce::Decibels::decibelsToGain (static_cast<T> (Constants::outputSilenceThresholdDb)) };
+    if (outputAudio.getMagnitude (startSample, numSamples) < silenceThreshold)
+        silentTailSamples = std::min (silentTailSamples + numSamples, idleHoldSamples);
+    else
+        silentTailSamples = 0;
+
     gainWrapper->process (context);
+    timer.lap (ProfilerStage::masterGain);
 }
@@ -23,11 +23,14 @@
 #pragma once
 
 #include "LockFreeSynthesiser.h"
+#include "PhatVoiceFilter.h"
 #include "PhatOscillators.h"
 
 #include "../UI/ButtonGroupComponent.h"
 #include "../Utility/Helpers.h"
 #include "../Utility/Macros.h"
+#include "../Utility/StageProfiler.h"
+#include "../Utility/TraceLog.h"
 
 #if EFFECTS_PROCESSOR_PER_VOICE
 #include "PhatEffectsProcessor.hpp"
@@ -77,6 +80,25 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
     }
     void setLfoAmount (float newAmount) { lfoAmount = newAmount; }
 
+    /** @brief Sets the output level under which a voice in its release phase is considered silent and is
+     *  stopped right away, instead of rendering the rest of a potentially long release tail. Pass
+     *  -std::numeric_limits<T>::infinity() to always render the whole release.
+     */
+    void setCullThreshold (T thresholdDb) { cullThresholdGain = juce::Decibels::decibelsToGain (thresholdDb, T (-1000)); }
+
+    /** @brief Fades this voice out over the next Constants::killRampSamples rendered samples, then clears its note.
+     *  Used when a stolen voice gets handed off to the synth's ghost pool, so the fade is rendered as part of the
+     *  regular render calls instead of all at once when the new note starts.
+     */
+    void startFadeOut();
+    bool isFadingOut() const noexcept { return fadeOutSamplesLeft > 0; }
+
+    /** @brief True if the voice will output anything in its next render call, including a pending kill ramp. */
+    bool isRendering() const { return isVoiceActive() || currentlyKillingVoice; }
+
+    /** @brief Returns the decaying peak level of this voice's output, as a gain. */
+    T getOutputLevel() const noexcept { return outputLevel; }
+
     void setFilterCutoff (T newValue)
     {
         curFilterCutoff = newValue;
@@ -95,10 +117,16 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
         setFilterResonanceInternal (curFilterResonance);
     }
 
+    void setFilterModel (FilterModel::Values newModel)
+    {
+        filterAndGainProcessorChain.template get<(int) ProcessorId::filterIndex>().setModel (newModel);
+    }
+
     void pitchWheelMoved (int newPitchWheelValue) override { oscillators.pitchWheelMoved (newPitchWheelValue); }
 
     void startNote (int midiNoteNumber, float velocity, juce::SynthesiserSound* /*sound*/, int currentPitchWheelPosition) override;
     void stopNote (float /*velocity*/, bool allowTailOff) override;
+    bool retriggerNote (int midiNoteNumber, float velocity, juce::SynthesiserSound* /*sound*/, int currentPitchWheelPosition) override;
 
     bool canPlaySound (juce::SynthesiserSound* sound) override { return dynamic_cast<ProPhatSound*> (sound) != nullptr; }
 
@@ -119,19 +147,29 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
 
     int getVoiceId() const { return voiceId; }
 
+    /** @brief Times this voice's oscillators, filter and envelopes into profiler, when it's enabled. Can be null. */
+    void setProfiler (StageProfiler* newProfiler) { profiler = newProfiler; }
+
   private:
     juce::AudioProcessorValueTreeState& state;
 
     int voiceId;
 
+    StageProfiler* profiler { nullptr };
+
     T lfoCutOffContributionHz { 0 };
 
+    /** Sets the cutoff before the filter envelope is applied. This is ramped over lfoUpdateRate samples,
+    *   and the filter envelope is then applied to it on a sample basis in renderNextBlockTemplate().
+    */
     void setFilterCutoffInternal (T curCutOff)
     {
-        const auto limitedCutOff { juce::jlimit (T (Constants::cutOffRange.start), T (Constants::cutOffRange.end), curCutOff) };
-        filterAndGainProcessorChain.template get<(int) ProcessorId::filterIndex>().setCutoffFrequencyHz (limitedCutOff);
+        baseCutoffSmoother.setTargetValue (curCutOff);
     }
 
+    /** Fills cutoffBuffer with one cutoff per sample, and advances the filter envelope by numSamples. */
+    void fillCutoffBuffer (int numSamples);
+
     void setFilterResonanceInternal (T curResonance)
     {
         const auto limitedResonance { juce::jlimit (T (0), T (1), curResonance) };
@@ -144,6 +182,7 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
     void        processKillOverlap (juce::dsp::AudioBlock<T>& block, int curBlockSize);
     void        assertForDiscontinuities (juce::AudioBuffer<T>& outputBuffer, int startSample, int numSamples, juce::String dbgPrefix);
     void        applyKillRamp (juce::AudioBuffer<T>& outputBuffer, int startSample, int numSamples);
+    void        processFadeOut (juce::dsp::AudioBlock<T>& block);
 
     PhatOscillators<T> oscillators;
 
@@ -152,8 +191,9 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
     //TODO replace this currentlyKillingVoice bool with a check in the bitfield that voicesBeingKilled will become
     bool           currentlyKillingVoice = false;
     std::set<int>* voicesBeingKilled;
+    int            fadeOutSamplesLeft = 0;
 
-    juce::dsp::ProcessorChain<juce::dsp::LadderFilter<T>, juce::dsp::Gain<T>> filterAndGainProcessorChain;
+    juce::dsp::ProcessorChain<PhatVoiceFilter<T>, juce::dsp::Gain<T>> filterAndGainProcessorChain;
     //TODO: use a slider for this
     static constexpr auto envelopeAmount { 2 };
 #if EFFECTS_PROCESSOR_PER_VOICE
@@ -170,9 +210,14 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
 
     //lfo stuff
     //TODO #63: how is this actually used? Especially because we always use only the first sample of the lfo process call?
-    static constexpr auto    lfoUpdateRate    = 100;
+    static constexpr auto    lfoUpdateRate    = Constants::renderQuantum;
     int                      lfoUpdateCounter = lfoUpdateRate;
 
+    //the cutoff is computed per sample, and our sub blocks are never longer than lfoUpdateRate
+    std::array<T, lfoUpdateRate> cutoffBuffer {};
+    //the base cutoff and lfo contribution only change every lfoUpdateRate samples, so we ramp them over that
+    juce::SmoothedValue<T>       baseCutoffSmoother { T (Constants::defaultFilterCutoff) }, lfoCutoffSmoother { T (0) };
+
     std::array<juce::dsp::Oscillator<T>, LfoShape::totalSelectable> lfos;
     std::atomic<juce::dsp::Oscillator<T>*> curLfo {nullptr};
 
@@ -188,6 +233,11 @@ class ProPhatVoice : public LockFreeSynthesiserVoice, public juce::AudioProcesso
     bool rampingUp         = false;
     int  rampUpSamplesLeft = 0;
 
+    //peak follower on the voice output, used to cull release tails once they're inaudible
+    T              outputLevel { 0 };
+    T              outputLevelDecay { 0 };
+    std::atomic<T> cullThresholdGain { juce::Decibels::decibelsToGain (T (Constants::defaultVoiceCullThresholdDb)) };
+
     T tiltCutoff { 0.f };
 
     int curPreparedSamples = 0;
@@ -249,7 +299,10 @@ void ProPhatVoice<T>::renderNextBlockTemplate (juce::AudioBuffer<T>& outputBuffe
     //with new buffer sizes, so just making sure we're not taking more samples than the audio block was prepared with.
     jassert (numSamples <= curPreparedSamples);
     numSamples = juce::jmin (numSamples, curPreparedSamples);
-    auto& currentAudioBlock { oscillators.prepareRender (numSamples) };
+    //prepareRender() hands out the whole scratch block, we only want what we render in this call
+    auto currentAudioBlock { oscillators.prepareRender (numSamples).getSubBlock (0, (size_t) numSamples) };
+
+    StageTimer timer { profiler, voiceId };
 
     for (int pos = 0; pos < numSamples;)
     {
@@ -257,41 +310,50 @@ void ProPhatVoice<T>::renderNextBlockTemplate (juce::AudioBuffer<T>& outputBuffe
 
         //render the oscillators over the subBlockSize
         juce::dsp::AudioBlock<T> oscBlock { oscillators.process (pos, subBlockSize) };
+        timer.lap (ProfilerStage::oscillators);
+
+        //apply the filter with an audio-rate cutoff, then the gain
+        fillCutoffBuffer (subBlockSize);
+        filterAndGainProcessorChain.template get<(int) ProcessorId::filterIndex>().process (oscBlock, cutoffBuffer.data());
 
-        //apply filter and gain
         juce::dsp::ProcessContextReplacing<T> oscContext (oscBlock);
-        filterAndGainProcessorChain.process (oscContext);
+        filterAndGainProcessorChain.template get<(int) ProcessorId::masterGainIndex>().process (oscContext);
+        timer.lap (ProfilerStage::filter);
 
 #if EFFECTS_PROCESSOR_PER_VOICE
         effectsProcessor.process (oscContext);
+        timer.lap (ProfilerStage::effects);
 #endif
 
-        //apply the envelopes. We calculate and apply the amp envelope on a sample basis,
-        //but for the filter env we increment it on a sample basis but only apply it
-        //once per buffer, just like the LFO -- see below.
-        auto filterEnvelope { 0.f };
+        //apply the amp envelope. The filter envelope was already applied on a sample basis in fillCutoffBuffer()
         {
             const auto numChannels { oscBlock.getNumChannels() };
+            auto       level { outputLevel };
             for (auto i = 0; i < subBlockSize; ++i)
             {
-                //TODO: we only need the last of these right, not sure this needs to be in this loop
-                //calculate and store filter envelope
-                filterEnvelope = filterADSR.getNextSample();
-
                 //TODO: if there's an efficient way to render the ampEnv here we could use SIMD for the multiplication below
                 //calculate and apply amp envelope
                 const auto ampEnv = ampADSR.getNextSample();
+                level *= outputLevelDecay;
                 for (size_t c = 0; c < numChannels; ++c)
-                    oscBlock.getChannelPointer (c)[i] *= ampEnv;
+                {
+                    auto& sample = oscBlock.getChannelPointer (c)[i];
+                    sample *= ampEnv;
+                    level = juce::jmax (level, std::abs (sample));
+                }
             }
+            outputLevel = level;
 
-            if (currentlyReleasingNote && ! ampADSR.isActive())
+            //stop the voice when the release envelope is done, or when what's left of it is too quiet to hear.
+            //In that second case the level is so low that cutting it doesn't need a kill ramp
+            if (currentlyReleasingNote && (! ampADSR.isActive() || outputLevel < cullThresholdGain.load()))
             {
                 currentlyReleasingNote  = false;
                 justDoneReleaseEnvelope = true;
                 stopNote (0.f, false);
             }
         }
+        timer.lap (ProfilerStage::envelopes);
 
         if (rampingUp)
             processRampUp (oscBlock, (int) subBlockSize);
@@ -309,14 +371,13 @@ void ProPhatVoice<T>::renderNextBlockTemplate (juce::AudioBuffer<T>& outputBuffe
             updateLfo();
         }
 
-        //apply our filter envelope once per buffer
-        const auto curCutOff { (curFilterCutoff + tiltCutoff) * (1 + envelopeAmount * filterEnvelope) + lfoCutOffContributionHz };
-        setFilterCutoffInternal (curCutOff);
-
         //increment our position
         pos += subBlockSize;
     }
 
+    if (isFadingOut())
+        processFadeOut (currentAudioBlock);
+
     //add everything to the output buffer
     juce::dsp::AudioBlock<T> (outputBuffer).getSubBlock ((size_t) startSample, (size_t) numSamples).add (currentAudioBlock);
 
@@ -328,16 +389,38 @@ void ProPhatVoice<T>::renderNextBlockTemplate (juce::AudioBuffer<T>& outputBuffe
 #endif
 }
 
+template <std::floating_point T>
+void ProPhatVoice<T>::fillCutoffBuffer (int numSamples)
+{
+    jassert (numSamples <= (int) cutoffBuffer.size());
+
+    const auto minCutoff { T (Constants::cutOffRange.start) };
+    const auto maxCutoff { T (Constants::cutOffRange.end) };
+
+    for (auto i = 0; i < numSamples; ++i)
+    {
+        const auto filterEnvelope { static_cast<T> (filterADSR.getNextSample()) };
+        const auto curCutOff { baseCutoffSmoother.getNextValue() * (1 + envelopeAmount * filterEnvelope) + lfoCutoffSmoother.getNextValue() };
+        cutoffBuffer[(size_t) i] = juce::jlimit (minCutoff, maxCutoff, curCutOff);
+    }
+}
+
 template <std::floating_point T>
 void ProPhatVoice<T>::prepare (const juce::dsp::ProcessSpec& spec)
 {
     curPreparedSamples = (int) spec.maximumBlockSize;
     oscillators.prepare (spec);
 
+    //the peak follower needs to hold long enough to bridge the zero crossings of our lowest notes
+    outputLevelDecay = static_cast<T> (std::exp (-1. / (Constants::voiceLevelHoldSeconds * spec.sampleRate)));
+    outputLevel      = 0;
+
     overlap = std::make_unique<juce::AudioBuffer<T>> (spec.numChannels, Constants::killRampSamples);
     overlap->clear();
 
     filterAndGainProcessorChain.prepare (spec);
+    baseCutoffSmoother.reset (lfoUpdateRate);
+    lfoCutoffSmoother.reset (lfoUpdateRate);
 
     ampADSR.setSampleRate (spec.sampleRate);
     ampADSR.setParameters (ampParams);
@@ -367,6 +450,7 @@ void ProPhatVoice<T>::addParamListenersToState()
     //add our synth as listener to all parameters so we can do automations
     state.addParameterListener (filterCutoffID.getParamID(), this);
     state.addParameterListener (filterResonanceID.getParamID(), this);
+    state.addParameterListener (filterModelID.getParamID(), this);
     state.addParameterListener (filterEnvAttackID.getParamID(), this);
     state.addParameterListener (filterEnvDecayID.getParamID(), this);
     state.addParameterListener (filterEnvSustainID.getParamID(), this);
@@ -393,6 +477,7 @@ void ProPhatVoice<T>::addParamListenersToState()
     state.addParameterListener (phaserParam2ID.getParamID(), this);
 
     state.addParameterListener (effectSelectedID.getParamID(), this);
+    state.addParameterListener (reverbAlgorithmID.getParamID(), this);
 #endif
 }
 
@@ -430,6 +515,8 @@ void ProPhatVoice<T>::parameterChanged (const juce::String& parameterID, float n
         setFilterCutoff (newValue);
     else if (parameterID == filterResonanceID.getParamID())
         setFilterResonance (newValue);
+    else if (parameterID == filterModelID.getParamID())
+        setFilterModel (static_cast<FilterModel::Values> (newValue));
 
 #if EFFECTS_PROCESSOR_PER_VOICE
     else if (parameterID == reverbParam1ID.getParamID() || parameterID == reverbParam2ID.getParamID()
@@ -455,6 +542,8 @@ void ProPhatVoice<T>::parameterChanged (const juce::String& parameterID, float n
         if (isVoiceActive())
             effectsProcessor.changeEffect (effect);
     }
+    else if (parameterID == reverbAlgorithmID.getParamID())
+        effectsProcessor.setReverbAlgorithm (static_cast<ReverbAlgorithm::Values> (newValue));
 #endif
 
     else
@@ -552,6 +641,7 @@ void ProPhatVoice<T>::updateLfo()
 
         case LfoDest::filterCutOff:
             lfoCutOffContributionHz = juce::jmap (lfoOut, T (0), T (1), T (10), T (10000));
+            lfoCutoffSmoother.setTargetValue (lfoCutOffContributionHz);
             break;
 
         case LfoDest::filterResonance:
@@ -569,6 +659,7 @@ void ProPhatVoice<T>::startNote (int midiNoteNumber, float velocity, juce::Synth
 #if DEBUG_VOICES
     DBG ("\tDEBUG ProPhatVoice::startNote() with voiceId : " + juce::String (voiceId));
 #endif
+    TRACE_EVENT (TraceEventType::voiceStart, voiceId, midiNoteNumber, juce::roundToInt (velocity * 127.f));
 
     ampADSR.setParameters (ampParams);
     ampADSR.reset();
@@ -580,12 +671,44 @@ void ProPhatVoice<T>::startNote (int midiNoteNumber, float velocity, juce::Synth
 
     oscillators.updateOscFrequencies (midiNoteNumber, velocity, currentPitchWheelPosition);
 
-    rampingUp         = true;
+    outputLevel        = 0;
+    fadeOutSamplesLeft = 0;
+    rampingUp          = true;
     rampUpSamplesLeft = Constants::rampUpSamples;
 
     oscillators.updateOscLevels();
 }
 
+template <std::floating_point T>
+bool ProPhatVoice<T>::retriggerNote (int midiNoteNumber, float velocity, juce::SynthesiserSound* /*sound*/, int currentPitchWheelPosition)
+{
+    //a voice that's being killed needs to finish its kill ramp, so let the synth start a new one
+    if (currentlyKillingVoice)
+        return false;
+
+#if DEBUG_VOICES
+    DBG ("\tDEBUG ProPhatVoice::retriggerNote() with voiceId : " + juce::String (voiceId));
+#endif
+    TRACE_EVENT (TraceEventType::voiceRetrigger, voiceId, midiNoteNumber, juce::roundToInt (velocity * 127.f));
+
+    //no reset() here: juce::ADSR::noteOn() restarts the attack from wherever the envelope currently is,
+    //so the level never jumps and we don't need a ramp up or a kill ramp
+    ampADSR.setParameters (ampParams);
+    ampADSR.noteOn();
+
+    filterADSR.setParameters (filterEnvParams);
+    filterADSR.noteOn();
+
+    currentlyReleasingNote  = false;
+    justDoneReleaseEnvelope = false;
+
+    //oscillator phases and filter state are left untouched
+    oscillators.updateOscFrequencies (midiNoteNumber, velocity, currentPitchWheelPosition);
+    oscillators.updateOscLevels();
+
+    return true;
+}
+
 template <std::floating_point T>
 void ProPhatVoice<T>::stopNote (float /*velocity*/, bool allowTailOff)
 {
@@ -598,6 +721,7 @@ void ProPhatVoice<T>::stopNote (float /*velocity*/, bool allowTailOff)
 #if DEBUG_VOICES
         DBG ("\tDEBUG ProPhatVoice<T>::stopNote with tailoff for voiceId: " << juce::String (voiceId));
 #endif
+        TRACE_EVENT (TraceEventType::voiceRelease, voiceId);
     }
     else
     {
@@ -607,6 +731,7 @@ void ProPhatVoice<T>::stopNote (float /*velocity*/, bool allowTailOff)
 #if DEBUG_VOICES
             DBG ("\tProPhatVoice<T>::stopNote() starting to kill voice: " + juce::String (voiceId));
 #endif
+            TRACE_EVENT (TraceEventType::voiceKill, voiceId);
             rampingUp = false;
 
             //get ready to kill the voice
@@ -621,6 +746,7 @@ void ProPhatVoice<T>::stopNote (float /*velocity*/, bool allowTailOff)
         }
 
         justDoneReleaseEnvelope = false;
+        fadeOutSamplesLeft      = 0;
         clearCurrentNote();
 
 #if DEBUG_VOICES
@@ -707,6 +833,48 @@ void ProPhatVoice<T>::processKillOverlap (juce::dsp::AudioBlock<T>& block, int c
     }
 }
 
+template <std::floating_point T>
+void ProPhatVoice<T>::startFadeOut()
+{
+    jassert (isVoiceActive() && ! currentlyKillingVoice);
+
+    rampingUp          = false;
+    fadeOutSamplesLeft = Constants::killRampSamples;
+}
+
+template <std::floating_point T>
+void ProPhatVoice<T>::processFadeOut (juce::dsp::AudioBlock<T>& block)
+{
+    const auto numSamples { (int) block.getNumSamples() };
+    const auto curFadeLength { juce::jmin (numSamples, fadeOutSamplesLeft) };
+    const auto incr { T (-1) / static_cast<T> (Constants::killRampSamples) };
+    const auto startGain { static_cast<T> (fadeOutSamplesLeft) / static_cast<T> (Constants::killRampSamples) };
+
+    for (size_t c = 0; c < block.getNumChannels(); ++c)
+    {
+        auto* samples = block.getChannelPointer (c);
+        for (int i = 0; i < curFadeLength; ++i)
+            samples[i] *= startGain + static_cast<T> (i) * incr;
+    }
+
+    fadeOutSamplesLeft -= curFadeLength;
+
+    if (fadeOutSamplesLeft == 0)
+    {
+        //whatever we rendered past the end of the fade is silence
+        if (curFadeLength < numSamples)
+            block.getSubBlock ((size_t) curFadeLength).clear();
+
+        currentlyReleasingNote  = false;
+        justDoneReleaseEnvelope = false;
+        clearCurrentNote();
+
+#if DEBUG_VOICES
+        DBG ("\tDEBUG ProPhatVoice<T>::processFadeOut() DONE for voiceId: " + juce::String (voiceId));
+#endif
+    }
+}
+
 template <std::floating_point T>
 void ProPhatVoice<T>::applyKillRamp (juce::AudioBuffer<T>& outputBuffer, int startSample, int numSamples)
 {
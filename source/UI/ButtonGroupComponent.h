@@ -28,9 +28,11 @@
 enum defaults
 {
     defaultOscShape = (int) OscShape::saw,
+    defaultFilterModel = (int) FilterModel::analog,
     defaultLfoShape = (int) LfoShape::triangle,
     defaultLfoDest = (int) LfoDest::filterCutOff,
     defaultEffect = (int) SelectedEffect::none,
+    defaultReverbAlgorithm = (int) ReverbAlgorithm::classic,
 };
 
 class FilledDrawableButton : public juce::DrawableButton
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "DeadlinePanel.h"
+
+DeadlinePanel::DeadlinePanel (DeadlineMonitor& monitor)
+    : deadlineMonitor (monitor)
+{
+    statsLabel.setJustificationType (juce::Justification::topLeft);
+    addAndMakeVisible (statsLabel);
+
+    resetButton.onClick = [this]
+    {
+        //the audio thread clears the monitor on its next block, until then we show nothing
+        deadlineMonitor.reset();
+        snapshot = {};
+        repaint();
+    };
+    addAndMakeVisible (resetButton);
+
+    startTimer (250);
+}
+
+void DeadlinePanel::timerCallback()
+{
+    snapshot = deadlineMonitor.getSnapshot();
+
+    statsLabel.setText ("blocks: " + juce::String (snapshot.numBlocks)
+                            + "\nmisses: " + juce::String (snapshot.misses)
+                            + "\nnear misses: " + juce::String (snapshot.nearMisses)
+                            + "\np99: " + juce::String (100. * snapshot.getPercentile (.99), 1) + "%"
+                            + "\nworst: " + juce::String (100. * snapshot.worstFraction, 1) + "%",
+                        juce::dontSendNotification);
+
+    repaint (histogramBounds.getSmallestIntegerContainer());
+}
+
+void DeadlinePanel::paint (juce::Graphics& g)
+{
+    g.setColour (juce::Colours::white.withAlpha (.1f));
+    g.fillRect (histogramBounds);
+
+    //the x axis is log scale like the bins, so every bin gets the same width
+    const auto binWidth { histogramBounds.getWidth() / DeadlineMonitor::numBins };
+    const auto xForFraction = [this, binWidth] (double fraction)
+    {
+        const auto bin { DeadlineMonitor::getBinForFraction (fraction) };
+        return histogramBounds.getX() + binWidth * (float) bin;
+    };
+
+    //shade the near miss and miss zones
+    const auto nearMissX { xForFraction (DeadlineMonitor::nearMissFraction) };
+    const auto missX { xForFraction (1.) };
+    g.setColour (juce::Colours::orange.withAlpha (.2f));
+    g.fillRect (histogramBounds.withLeft (nearMissX).withRight (missX));
+    g.setColour (juce::Colours::red.withAlpha (.2f));
+    g.fillRect (histogramBounds.withLeft (missX));
+
+    //bar heights are log scale as well, otherwise the rare slow blocks we care about are invisible
+    const auto maxCount { *std::max_element (snapshot.counts.begin(), snapshot.counts.end()) };
+    if (maxCount > 0)
+    {
+        const auto maxLog { std::log1p ((float) maxCount) };
+
+        g.setColour (juce::Colours::white);
+        for (int bin = 0; bin < DeadlineMonitor::numBins; ++bin)
+        {
+            const auto count { snapshot.counts[(size_t) bin] };
+            if (count == 0)
+                continue;
+
+            const auto barHeight { histogramBounds.getHeight() * std::log1p ((float) count) / maxLog };
+            g.fillRect (histogramBounds.getX() + binWidth * (float) bin, histogramBounds.getBottom() - barHeight, juce::jmax (1.f, binWidth - 1.f), barHeight);
+        }
+    }
+
+    g.setColour (juce::Colours::lightgrey);
+    g.setFont (12.f);
+    for (auto fraction : { .01, .1, 1. })
+        g.drawText (juce::String (fraction * 100., 0) + "%", juce::Rectangle<float> (xForFraction (fraction), histogramBounds.getY(), 40.f, 14.f), juce::Justification::left);
+}
+
+void DeadlinePanel::resized()
+{
+    auto bounds { getLocalBounds() };
+    auto statsColumn { bounds.removeFromRight (160) };
+
+    resetButton.setBounds (statsColumn.removeFromBottom (30).reduced (2));
+    statsLabel.setBounds (statsColumn);
+    histogramBounds = bounds.reduced (4).toFloat();
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../Utility/DeadlineMonitor.h"
+#include "juce_gui_basics/juce_gui_basics.h"
+
+/** Shows the processor's DeadlineMonitor: the histogram of block times relative to their deadline,
+*   the number of misses and near misses, and a button to start over.
+*/
+class DeadlinePanel : public juce::Component
+                    , private juce::Timer
+{
+public:
+    explicit DeadlinePanel (DeadlineMonitor& monitor);
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    DeadlineMonitor& deadlineMonitor;
+    DeadlineMonitor::Snapshot snapshot;
+
+    juce::Rectangle<float> histogramBounds;
+    juce::Label statsLabel;
+    juce::TextButton resetButton { "Reset" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeadlinePanel)
+};
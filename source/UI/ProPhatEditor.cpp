@@ -50,6 +50,9 @@ constexpr auto buttonGroupColumnW   { 140.f };
 constexpr auto numSliderColumn      { 8 };
 constexpr auto sliderColumnW        { 98.f };
 
+constexpr auto profilerPanelHeight  { 160.f };
+constexpr auto deadlinePanelHeight  { 120.f };
+
 constexpr auto totalHeight          { 2 * overallGap + logoHeight + 4 * panelGap + lineCount * lineH };
 constexpr auto totalWidth           { 2 * overallGap + 4 * panelGap + numButtonGroupColumn * buttonGroupColumnW + numSliderColumn * sliderColumnW };
 }
@@ -86,6 +89,7 @@ ProPhatEditor::ProPhatEditor (ProPhatProcessor& p)
     , filterEnvDecayAttachment (p.state, filterEnvDecayID.getParamID(), filterEnvDecaySlider)
     , filterEnvSustainAttachment (p.state, filterEnvSustainID.getParamID(), filterEnvSustainSlider)
     , filterEnvReleaseAttachment (p.state, filterEnvReleaseID.getParamID(), filterEnvReleaseSlider)
+    , filterModelButtons (p.state, filterModelID.getParamID(), std::make_unique<FilterModel> (FilterModel()), filterModelDesc, {filterModel0, filterModel1, filterModel2})
 
     //AMPLIFIER
     , ampGroup ("ampGroup", ampGroupDesc)
@@ -113,19 +117,14 @@ ProPhatEditor::ProPhatEditor (ProPhatProcessor& p)
 
     //OTHER
     , masterGainAttachment (p.state, masterGainID.getParamID(), masterGainSlider)
+    , profilerPanel (p.profiler)
+    , deadlinePanel (p.deadlineMonitor)
 {
     phatProcessor.midiListeners.add (this);
-#if CPU_USAGE
-    setSize (width, height + 50);
-
-    cpuUsageLabel.setText ("CPU Usage", juce::dontSendNotification);
-    cpuUsageText.setJustificationType (juce::Justification::left);
-    addAndMakeVisible (cpuUsageLabel);
-    addAndMakeVisible (cpuUsageText);
-    startTimer (500);
-#else
     setSize (static_cast<int> (totalWidth), static_cast<int> (totalHeight));
-#endif
+
+    addChildComponent (profilerPanel);
+    addChildComponent (deadlinePanel);
 
     setLookAndFeel (&lnf);
     setResizable (true, true);
@@ -172,9 +171,9 @@ ProPhatEditor::ProPhatEditor (ProPhatProcessor& p)
               { osc1FreqDesc,          osc1TuningDesc,         juce::String (),   oscSubOctDesc,      osc2FreqDesc,         osc2TuningDesc,         juce::String (),   oscMixDesc,         oscNoiseDesc,         oscSlopDesc},
               { &osc1FreqSlider,       &osc1TuningSlider,      &osc1ShapeButtons, &oscSubSlider,      &osc2FreqSlider,      &osc2TuningSlider,      &osc2ShapeButtons, &oscMixSlider,      &oscNoiseSlider,      &oscSlopSlider});
 
-    addGroup (filterGroup, { &filterCutoffLabel,     &filterResonanceLabel,      &filterEnvAttackLabel,  &filterEnvDecayLabel,   &filterEnvSustainLabel,  &filterEnvReleaseLabel },
-              { filterCutoffSliderDesc, filterResonanceSliderDesc,  ampAttackSliderDesc,    ampDecaySliderDesc,     ampSustainSliderDesc,    ampReleaseSliderDesc },
-              { &filterCutoffSlider,    &filterResonanceSlider,     &filterEnvAttackSlider, &filterEnvDecaySlider,  &filterEnvSustainSlider, &filterEnvReleaseSlider });
+    addGroup (filterGroup, { &filterCutoffLabel,     &filterResonanceLabel,      nullptr,             &filterEnvAttackLabel,  &filterEnvDecayLabel,   &filterEnvSustainLabel,  &filterEnvReleaseLabel },
+              { filterCutoffSliderDesc, filterResonanceSliderDesc,  juce::String (),     ampAttackSliderDesc,    ampDecaySliderDesc,     ampSustainSliderDesc,    ampReleaseSliderDesc },
+              { &filterCutoffSlider,    &filterResonanceSlider,     &filterModelButtons, &filterEnvAttackSlider, &filterEnvDecaySlider,  &filterEnvSustainSlider, &filterEnvReleaseSlider });
 
     addGroup (ampGroup, { &masterGainLabel,  &ampAttackLabel,     &ampDecayLabel,     &ampSustainLabel,     &ampReleaseLabel },
               { masterGainDesc,    ampAttackSliderDesc, ampDecaySliderDesc, ampSustainSliderDesc, ampReleaseSliderDesc },
@@ -198,6 +197,7 @@ ProPhatEditor::ProPhatEditor (ProPhatProcessor& p)
 
     osc1ShapeButtons.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, osc1ShapeID.getParamID())));
     osc2ShapeButtons.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, osc2ShapeID.getParamID())));
+    filterModelButtons.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, filterModelID.getParamID())));
     lfoShapeButtons.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, lfoShapeID.getParamID())));
     lfoDestButtons.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, lfoDestID.getParamID())));
     effectChangeButton.setSelectedButton (static_cast<int> (Helpers::getRangedParamValue (phatProcessor.state, effectSelectedID.getParamID())));
@@ -325,6 +325,9 @@ void ProPhatEditor::buttonClicked (juce::Button*)
     m.addItem (3, juce::translate ("Load a saved state..."));
     m.addSeparator ();
     m.addItem (4, juce::translate ("Reset to default state"));
+    m.addSeparator ();
+    m.addItem (5, juce::translate ("Show profiler"), true, profilerPanel.isVisible());
+    m.addItem (6, juce::translate ("Show render deadline"), true, deadlinePanel.isVisible());
 
     m.showMenuAsync (juce::PopupMenu::Options (),
                      juce::ModalCallbackFunction::forComponent (menuCallback, this));
@@ -332,6 +335,14 @@ void ProPhatEditor::buttonClicked (juce::Button*)
 
 void ProPhatEditor::handleMenuResult (int result)
 {
+    //these don't need the plugin holder
+    if (result == 5 || result == 6)
+    {
+        auto& panel { result == 5 ? static_cast<juce::Component&> (profilerPanel) : deadlinePanel };
+        setDiagnosticsPanelVisible (panel, ! panel.isVisible());
+        return;
+    }
+
     if (const auto app { dynamic_cast<ProPhatApplication*> (juce::JUCEApplication::getInstance()) })
     {
         if (const auto pluginHolder { app->getPluginHolder() })
@@ -351,6 +362,19 @@ void ProPhatEditor::handleMenuResult (int result)
 }
 #endif
 
+void ProPhatEditor::setDiagnosticsPanelVisible (juce::Component& panel, bool shouldBeVisible)
+{
+    jassert (&panel == &profilerPanel || &panel == &deadlinePanel);
+
+    if (shouldBeVisible == panel.isVisible())
+        return;
+
+    panel.setVisible (shouldBeVisible);
+
+    const auto panelHeight { static_cast<int> ((&panel == &profilerPanel ? profilerPanelHeight : deadlinePanelHeight) + panelGap) };
+    setSize (getWidth(), getHeight() + (shouldBeVisible ? panelHeight : -panelHeight));
+}
+
 void ProPhatEditor::paint (juce::Graphics& g)
 {
 #if USE_BACKGROUND_IMAGE
@@ -373,6 +397,17 @@ void ProPhatEditor::resized()
 {
     auto bounds = getLocalBounds().toFloat().reduced (overallGap);
 
+    //diagnostics panels stack at the bottom, under everything else
+    for (auto [panel, panelHeight] : { std::pair<juce::Component*, float> { &deadlinePanel, deadlinePanelHeight },
+                                       std::pair<juce::Component*, float> { &profilerPanel, profilerPanelHeight } })
+    {
+        if (! panel->isVisible())
+            continue;
+
+        panel->setBounds (bounds.removeFromBottom (panelHeight).toNearestInt());
+        bounds.removeFromBottom (panelGap);
+    }
+
     auto logoRow { bounds.removeFromTop (logoHeight) };
     const auto r { 7.5f };
     auto rightSection { logoRow.removeFromRight (70.f + 2 * r) };
@@ -431,7 +466,7 @@ void ProPhatEditor::resized()
     const auto oscSection { topSection.removeFromLeft (4 * sliderColumnW + buttonGroupColumnW + 2 * panelGap) };
     positionGroup (oscGroup, oscSection, { &osc1FreqSlider, &osc1TuningSlider, &osc1ShapeButtons, &oscSubSlider, &oscNoiseSlider,
                                            &osc2FreqSlider, &osc2TuningSlider, &osc2ShapeButtons, &oscMixSlider, &oscSlopSlider }, 2, 5);
-    positionGroup (filterGroup, topSection, { &filterCutoffSlider, &filterResonanceSlider, nullptr, nullptr, &filterEnvAttackSlider,&filterEnvDecaySlider, &filterEnvSustainSlider, &filterEnvReleaseSlider }, 2, 4);
+    positionGroup (filterGroup, topSection, { &filterCutoffSlider, &filterResonanceSlider, &filterModelButtons, nullptr, &filterEnvAttackSlider,&filterEnvDecaySlider, &filterEnvSustainSlider, &filterEnvReleaseSlider }, 2, 4);
 
     //second line
     positionGroup (lfoGroup, bottomSection.removeFromLeft (sliderColumnW + buttonGroupColumnW + panelGap), { &lfoShapeButtons, &lfoFreqSlider, &lfoDestButtons, &lfoAmountSlider }, 2, 2);
@@ -440,13 +475,6 @@ void ProPhatEditor::resized()
     positionGroup (effectGroup, effectSection, { &chorusParam1Slider, &chorusParam2Slider, &effectChangeButton }, 2, 2);
     positionGroup (effectGroup, effectSection, { &phaserParam1Slider, &phaserParam2Slider, &effectChangeButton }, 2, 2);
     positionGroup (ampGroup, bottomSection, { &ampAttackSlider, &ampDecaySlider, &ampSustainSlider, &ampReleaseSlider, &masterGainSlider }, 1, 5);
-
-#if CPU_USAGE
-    auto cpuSectionH = 100;
-
-    cpuUsageLabel.setBounds (10, getHeight() - 50, cpuSectionH, 50);
-    cpuUsageText.setBounds (10 + cpuSectionH, getHeight() - 50, getWidth() - 10 - cpuSectionH, 50);
-#endif
 }
 
 void ProPhatEditor::receivedMidiMessage (juce::MidiBuffer& /*midiMessages*/)
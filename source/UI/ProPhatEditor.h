@@ -25,7 +25,9 @@
 #include "../DSP/ProPhatProcessor.h"
 
 #include "ButtonGroupComponent.h"
+#include "DeadlinePanel.h"
 #include "ProPhatLookAndFeel.h"
+#include "ProfilerPanel.h"
 #include "SliderLabel.h"
 #include "SnappingSlider.h"
 
@@ -38,9 +40,6 @@ class ProPhatEditor : public juce::AudioProcessorEditor
 #if USE_NATIVE_TITLE_BAR
     , private juce::Button::Listener
 #endif
-#if CPU_USAGE
-    , public Timer
-#endif
 {
 public:
     ProPhatEditor (ProPhatProcessor&);
@@ -52,13 +51,10 @@ public:
     void handleAsyncUpdate () override;
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
-#if CPU_USAGE
-    void timerCallback() override
-    {
-       auto stats = phatProcessor.perfCounter.getStatisticsAndReset();
-       cpuUsageText.setText (juce::String (stats.averageSeconds, 6), juce::dontSendNotification);
-    }
-#endif
+    /** Shows one of the diagnostics panels (profiler or render deadline) under the rest of the editor,
+    *   growing the editor to make room for it.
+    */
+    void setDiagnosticsPanelVisible (juce::Component& panel, bool shouldBeVisible);
 
 private:
     ProPhatProcessor& phatProcessor;
@@ -108,6 +104,8 @@ private:
     SnappingSlider filterEnvAttackSlider, filterEnvDecaySlider, filterEnvSustainSlider, filterEnvReleaseSlider;
     juce::AudioProcessorValueTreeState::SliderAttachment filterEnvAttackAttachment, filterEnvDecayAttachment, filterEnvSustainAttachment, filterEnvReleaseAttachment;
 
+    ButtonGroupComponent filterModelButtons;
+
     //AMPLIFIER
     SliderLabel ampAttackLabel, ampDecayLabel, ampSustainLabel, ampReleaseLabel;
     SnappingSlider ampAttackSlider, ampDecaySlider, ampSustainSlider, ampReleaseSlider;
@@ -141,10 +139,8 @@ private:
     SnappingSlider masterGainSlider;
     juce::AudioProcessorValueTreeState::SliderAttachment masterGainAttachment;
 
-#if CPU_USAGE
-    juce::Label cpuUsageLabel;
-    juce::Label cpuUsageText;
-#endif
+    ProfilerPanel profilerPanel;
+    DeadlinePanel deadlinePanel;
 
     bool gotMidi { false };
 
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "ProfilerPanel.h"
+
+ProfilerPanel::ProfilerPanel (StageProfiler& stageProfiler)
+    : profiler (stageProfiler)
+{
+    enableButton.setToggleState (profiler.isEnabled(), juce::dontSendNotification);
+    enableButton.onClick = [this] { setProfiling (enableButton.getToggleState()); };
+    addAndMakeVisible (enableButton);
+
+    dumpButton.onClick = [this] { dumpReport(); };
+    addAndMakeVisible (dumpButton);
+
+    reportText.setMultiLine (true);
+    reportText.setReadOnly (true);
+    reportText.setScrollbarsShown (true);
+    reportText.setFont (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 13.f, juce::Font::plain));
+    addAndMakeVisible (reportText);
+
+    setProfiling (profiler.isEnabled());
+}
+
+ProfilerPanel::~ProfilerPanel()
+{
+    //the profiler outlives us, and costs nothing when nobody is looking at it
+    profiler.setEnabled (false);
+}
+
+void ProfilerPanel::resized()
+{
+    auto bounds { getLocalBounds() };
+    auto buttonColumn { bounds.removeFromLeft (100) };
+
+    enableButton.setBounds (buttonColumn.removeFromTop (30));
+    dumpButton.setBounds (buttonColumn.removeFromTop (30).reduced (2));
+    reportText.setBounds (bounds);
+}
+
+void ProfilerPanel::timerCallback()
+{
+    lastReport = profiler.getStatisticsAndReset();
+    reportText.setText (lastReport.toString(), juce::dontSendNotification);
+}
+
+void ProfilerPanel::setProfiling (bool shouldProfile)
+{
+    profiler.setEnabled (shouldProfile);
+
+    if (shouldProfile)
+    {
+        //drop whatever was left over from the last time we profiled
+        profiler.getStatisticsAndReset();
+        startTimer (500);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void ProfilerPanel::dumpReport()
+{
+    fileChooser = std::make_unique<juce::FileChooser> ("Save profile", juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("ProPhatProfile.txt"), "*.txt");
+
+    juce::Component::SafePointer safePtr { this };
+    fileChooser->launchAsync (juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles | juce::FileBrowserComponent::warnAboutOverwriting,
+                              [safePtr] (const juce::FileChooser& chooser)
+                              {
+                                  if (! safePtr)
+                                      return;
+
+                                  const auto file { chooser.getResult() };
+                                  if (file != juce::File() && ! file.replaceWithText (safePtr->lastReport.toString()))
+                                      juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Save profile", "Could not write " + file.getFullPathName());
+                              });
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../Utility/StageProfiler.h"
+#include "juce_gui_basics/juce_gui_basics.h"
+
+/** Turns the processor's StageProfiler on and off, shows its statistics a couple of times a second,
+*   and dumps the last ones to a text file.
+*/
+class ProfilerPanel : public juce::Component
+                    , private juce::Timer
+{
+public:
+    explicit ProfilerPanel (StageProfiler& stageProfiler);
+    ~ProfilerPanel() override;
+
+    void resized() override;
+
+private:
+    void timerCallback() override;
+    void setProfiling (bool shouldProfile);
+    void dumpReport();
+
+    StageProfiler& profiler;
+    StageProfiler::Report lastReport;
+
+    juce::ToggleButton enableButton { "Profile" };
+    juce::TextButton dumpButton { "Dump..." };
+    juce::TextEditor reportText;
+
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProfilerPanel)
+};
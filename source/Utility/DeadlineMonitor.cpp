@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "DeadlineMonitor.h"
+
+#include <cmath>
+
+DeadlineMonitor::DeadlineMonitor()
+    : ticksToSeconds (1. / (double) juce::Time::getHighResolutionTicksPerSecond())
+{
+    for (auto& count : counts)
+        count.store (0, std::memory_order_relaxed);
+}
+
+void DeadlineMonitor::prepare (double newSampleRate)
+{
+    sampleRate.store (newSampleRate, std::memory_order_relaxed);
+    reset();
+}
+
+void DeadlineMonitor::recordBlock (juce::int64 ticks, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    //we're the only writer, so the reset happens here rather than racing with us from the message thread
+    if (resetRequested.exchange (false, std::memory_order_acquire))
+    {
+        for (auto& count : counts)
+            count.store (0, std::memory_order_relaxed);
+
+        numBlocks.store (0, std::memory_order_relaxed);
+        misses.store (0, std::memory_order_relaxed);
+        nearMisses.store (0, std::memory_order_relaxed);
+        worstFraction.store (0., std::memory_order_relaxed);
+    }
+
+    const auto deadlineSeconds { numSamples / sampleRate.load (std::memory_order_relaxed) };
+    const auto fraction { (double) ticks * ticksToSeconds / deadlineSeconds };
+
+    counts[(size_t) getBinForFraction (fraction)].fetch_add (1, std::memory_order_relaxed);
+    numBlocks.fetch_add (1, std::memory_order_relaxed);
+
+    if (fraction >= 1.)
+        misses.fetch_add (1, std::memory_order_relaxed);
+    else if (fraction >= nearMissFraction)
+        nearMisses.fetch_add (1, std::memory_order_relaxed);
+
+    if (fraction > worstFraction.load (std::memory_order_relaxed))
+        worstFraction.store (fraction, std::memory_order_relaxed);
+}
+
+DeadlineMonitor::Snapshot DeadlineMonitor::getSnapshot() const
+{
+    Snapshot snapshot;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+        snapshot.counts[i] = counts[i].load (std::memory_order_relaxed);
+
+    snapshot.numBlocks = numBlocks.load (std::memory_order_relaxed);
+    snapshot.misses = misses.load (std::memory_order_relaxed);
+    snapshot.nearMisses = nearMisses.load (std::memory_order_relaxed);
+    snapshot.worstFraction = worstFraction.load (std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+double DeadlineMonitor::getBinLowerBound (int bin)
+{
+    if (bin <= 0)
+        return 0.;
+
+    return std::exp2 (minOctave + (double) (bin - 1) / binsPerOctave);
+}
+
+int DeadlineMonitor::getBinForFraction (double fraction)
+{
+    if (! (fraction > 0.))
+        return 0;
+
+    const auto bin { (int) std::floor ((std::log2 (fraction) - minOctave) * binsPerOctave) + 1 };
+    return juce::jlimit (0, numBins - 1, bin);
+}
+
+double DeadlineMonitor::Snapshot::getPercentile (double percentile) const
+{
+    juce::uint64 total { 0 };
+    for (auto count : counts)
+        total += count;
+
+    if (total == 0)
+        return 0.;
+
+    const auto target { (juce::uint64) std::ceil (juce::jlimit (0., 1., percentile) * (double) total) };
+
+    juce::uint64 cumulated { 0 };
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        cumulated += counts[(size_t) bin];
+        if (cumulated >= target)
+            return bin == numBins - 1 ? worstFraction : getBinLowerBound (bin + 1);
+    }
+
+    return worstFraction;
+}
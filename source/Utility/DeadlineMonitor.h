@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_core/juce_core.h"
+
+#include <array>
+#include <atomic>
+
+/** Tracks how close each processBlock call comes to its deadline, i.e. the time the audio in the block lasts.
+*
+*   Block times are stored as a fraction of numSamples / sampleRate in a log-scale histogram of atomic counters,
+*   written by the audio thread with no locks and read from the message thread at any time. A fraction of 1 or
+*   more is a deadline miss, which is an xrun unless the host has slack elsewhere; anything over
+*   nearMissFraction is a near miss and a good predictor of xruns on a busier machine or a heavier preset.
+*/
+class DeadlineMonitor
+{
+public:
+    static constexpr auto binsPerOctave { 4 };
+    static constexpr auto minOctave { -10 };  // 1/1024 of the deadline
+    static constexpr auto maxOctave { 2 };    // 4 times the deadline
+    static constexpr auto numBins { (maxOctave - minOctave) * binsPerOctave + 2 };  // plus one bin under and one over the range
+
+    static constexpr auto nearMissFraction { .8 };
+
+    DeadlineMonitor();
+
+    /** Message thread, before any blocks get recorded. */
+    void prepare (double newSampleRate);
+
+    /** Audio thread. Records a block of numSamples that took ticks of juce::Time::getHighResolutionTicks() to render. */
+    void recordBlock (juce::int64 ticks, int numSamples) noexcept;
+
+    /** Any thread. Clears everything, from the next recorded block on. */
+    void reset() noexcept { resetRequested.store (true, std::memory_order_release); }
+
+    struct Snapshot
+    {
+        std::array<juce::uint32, numBins> counts {};
+        juce::uint64 numBlocks { 0 };
+        juce::uint32 misses { 0 }, nearMisses { 0 };
+        double worstFraction { 0. };
+
+        /** Returns the upper bound of the bin that contains the given percentile [0, 1] of all blocks. */
+        double getPercentile (double percentile) const;
+    };
+
+    /** Message thread. Counts can be a block apart from each other, which doesn't matter for a histogram. */
+    Snapshot getSnapshot() const;
+
+    /** Returns the deadline fraction at the lower edge of the bin, 0 for the underflow bin. */
+    static double getBinLowerBound (int bin);
+    static int getBinForFraction (double fraction);
+
+private:
+    std::array<std::atomic<juce::uint32>, numBins> counts;
+    std::atomic<juce::uint64> numBlocks { 0 };
+    std::atomic<juce::uint32> misses { 0 }, nearMisses { 0 };
+    std::atomic<double> worstFraction { 0. };
+
+    std::atomic<bool> resetRequested { false };
+    std::atomic<double> sampleRate { 44100. };
+
+    const double ticksToSeconds;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeadlineMonitor)
+};
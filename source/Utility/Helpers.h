@@ -53,8 +53,24 @@ constexpr auto defaultOscMidiNote       { 48 }; //C2 on rev2
 constexpr auto middleCMidiNote          { 60 }; //C3 on rev2
 
 constexpr auto killRampSamples          { 300 };
+constexpr auto numGhostVoices           { 4 };
 constexpr auto rampUpSamples            { 100 };
 
+//we render in chunks of at most this many samples, and control-rate stuff like the lfos is updated at their boundaries
+constexpr auto renderQuantum            { 64 };
+constexpr auto defaultVoiceRetrigger    { false };
+
+//voices in their release phase get stopped once their output goes under this level
+constexpr auto defaultVoiceCullThresholdDb { -96.f };
+constexpr auto voiceLevelHoldSeconds       { .05 };
+
+//a processed block whose peak is under this level is reported as silent
+constexpr auto outputSilenceThresholdDb    { -96.f };
+
+//once no voice plays and the effects have stayed under the silence threshold for this long, we stop rendering.
+//Needs to be longer than any effect delay line, so that nothing can still be in flight
+constexpr auto idleHoldSeconds             { .2 };
+
 constexpr auto defaultOscLevel          { .4f };
 constexpr auto defaultMasterGain        { .8f };
 
@@ -67,6 +83,10 @@ constexpr float defaultLfoAmount        { 0.f };
 constexpr float defaultEffectParam1     { 0.f };
 constexpr float defaultEffectParam2     { 0.f };
 
+//the effect chain. The first slot is the one selected with effectSelectedID
+constexpr auto numEffectSlots           { 3 };
+constexpr float defaultEffectSlotMix    { 1.f };
+
 //envelope stuff
 constexpr auto minEnvelopeValue         { .01f };
 
@@ -119,11 +139,13 @@ const juce::ParameterID oscSlopID          { "Osc Slop", 1 };
 
 const juce::ParameterID filterCutoffID     { "Filter Cutoff", 1 };
 const juce::ParameterID filterResonanceID  { "Filter Reso", 1 };
+const juce::ParameterID filterModelID      { "Filter Model", 1 };
 
 const juce::ParameterID ampAttackID        { "Amp Attack", 1 };
 const juce::ParameterID ampDecayID         { "Amp Decay", 1 };
 const juce::ParameterID ampSustainID       { "Amp Sustain", 1 };
 const juce::ParameterID ampReleaseID       { "Amp Release", 1 };
+const juce::ParameterID voiceRetriggerID   { "Voice Retrigger", 1 };
 
 const juce::ParameterID filterEnvAttackID  { "Filter Attack", 1 };
 const juce::ParameterID filterEnvDecayID   { "Filter Decay", 1 };
@@ -143,6 +165,21 @@ const juce::ParameterID phaserParam1ID     { "Phaser Param1", 1 };
 const juce::ParameterID phaserParam2ID     { "Phaser Param2", 1 };
 
 const juce::ParameterID effectSelectedID   { "Current Effect", 1 };
+const juce::ParameterID reverbAlgorithmID  { "Reverb Algorithm", 1 };
+
+const juce::ParameterID effectSlot2ID       { "Effect Slot 2", 1 };
+const juce::ParameterID effectSlot3ID       { "Effect Slot 3", 1 };
+const juce::ParameterID effectSlot1BypassID { "Effect Slot 1 Bypass", 1 };
+const juce::ParameterID effectSlot2BypassID { "Effect Slot 2 Bypass", 1 };
+const juce::ParameterID effectSlot3BypassID { "Effect Slot 3 Bypass", 1 };
+const juce::ParameterID effectSlot1MixID    { "Effect Slot 1 Mix", 1 };
+const juce::ParameterID effectSlot2MixID    { "Effect Slot 2 Mix", 1 };
+const juce::ParameterID effectSlot3MixID    { "Effect Slot 3 Mix", 1 };
+
+//the parameters of each effect slot, indexed by slot
+const std::array<juce::ParameterID, Constants::numEffectSlots> effectSlotTypeIDs   { effectSelectedID, effectSlot2ID, effectSlot3ID };
+const std::array<juce::ParameterID, Constants::numEffectSlots> effectSlotBypassIDs { effectSlot1BypassID, effectSlot2BypassID, effectSlot3BypassID };
+const std::array<juce::ParameterID, Constants::numEffectSlots> effectSlotMixIDs    { effectSlot1MixID, effectSlot2MixID, effectSlot3MixID };
 
 const juce::ParameterID masterGainID       { "Master Gain", 1 };
 }
@@ -168,6 +205,7 @@ constexpr auto oscSlopDesc                  { "OSC SLOP" };
 constexpr auto filterGroupDesc              { "LOW-PASS FILTER" };
 constexpr auto filterCutoffSliderDesc       { "CUTOFF" };
 constexpr auto filterResonanceSliderDesc    { "RESONANCE" };
+constexpr auto filterModelDesc              { "MODEL" };
 
 constexpr auto ampGroupDesc                 { "AMPLIFIER" };
 constexpr auto ampAttackSliderDesc          { "ATTACK" };
@@ -198,6 +236,10 @@ constexpr auto oscShape2    { "Saw + Tri" };
 constexpr auto oscShape3    { "Triangle" };
 constexpr auto oscShape4    { "Pulse" };
 
+constexpr auto filterModel0 { "Eco" };
+constexpr auto filterModel1 { "Standard" };
+constexpr auto filterModel2 { "Analog" };
+
 constexpr auto lfoShape0    { "Triangle" };
 constexpr auto lfoShape1    { "Sawtooth" };
 //constexpr auto lfoShape2    { "Rev Saw" };
@@ -213,6 +255,10 @@ constexpr auto effect0      { "None" };
 constexpr auto effect1      { "Reverb" };
 constexpr auto effect2      { "Chorus" };
 constexpr auto effect3      { "Phaser" };
+
+constexpr auto reverbAlgorithm0 { "Classic" };
+constexpr auto reverbAlgorithm1 { "FDN 8" };
+constexpr auto reverbAlgorithm2 { "FDN 16" };
 }
 
 //====================================================================================================
@@ -259,6 +305,34 @@ struct OscShape : public Selection
     bool isNullSelectionAllowed () override { return true; }
 };
 
+struct FilterModel : public Selection
+{
+    enum Values
+    {
+        eco = 0,
+        standard,
+        analog,
+        totalSelectable
+    };
+
+    int getLastSelectionIndex () override { return totalSelectable - 1; }
+    bool isNullSelectionAllowed () override { return false; }
+};
+
+struct ReverbAlgorithm : public Selection
+{
+    enum Values
+    {
+        classic = 0,
+        fdn8,
+        fdn16,
+        totalSelectable
+    };
+
+    int getLastSelectionIndex () override { return totalSelectable - 1; }
+    bool isNullSelectionAllowed () override { return false; }
+};
+
 struct LfoShape : public Selection
 {
     enum Values
@@ -22,8 +22,6 @@
 
 #pragma once
 
-#define CPU_USAGE 0
-
 #define DEBUG_VOICES 0
 
 #define PRINT_ALL_SAMPLES 0
@@ -36,6 +34,8 @@
 
 #define USE_ONLY_ONE_VOICE_TO_FORCE_KILLRAMP 0
 
+#define ENABLE_TRACE_LOG 0
+
 #ifdef __clang__
 #define NONBLOCKING [[clang::nonblocking]]
 #else
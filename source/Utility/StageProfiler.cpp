@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "StageProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+StageProfiler::Statistics computeStatistics (std::vector<double>& micros)
+{
+    StageProfiler::Statistics stats;
+    if (micros.empty())
+        return stats;
+
+    std::sort (micros.begin(), micros.end());
+
+    stats.numCalls = (int) micros.size();
+    stats.minMicros = micros.front();
+    stats.maxMicros = micros.back();
+    stats.averageMicros = std::accumulate (micros.begin(), micros.end(), 0.) / (double) micros.size();
+    stats.p99Micros = micros[std::min (micros.size() - 1, (size_t) std::ceil (.99 * (double) micros.size()) - 1)];
+
+    return stats;
+}
+
+juce::String formatLine (const juce::String& name, const StageProfiler::Statistics& stats)
+{
+    return name.paddedRight (' ', 14)
+         + juce::String (stats.numCalls).paddedLeft (' ', 8)
+         + juce::String (stats.minMicros, 2).paddedLeft (' ', 10)
+         + juce::String (stats.averageMicros, 2).paddedLeft (' ', 10)
+         + juce::String (stats.maxMicros, 2).paddedLeft (' ', 10)
+         + juce::String (stats.p99Micros, 2).paddedLeft (' ', 10);
+}
+}
+
+StageProfiler::StageProfiler()
+    : ticksToMicros (1.e6 / (double) juce::Time::getHighResolutionTicksPerSecond())
+{
+}
+
+void StageProfiler::record (ProfilerStage stage, int voiceId, juce::int64 ticks) noexcept
+{
+    const auto write { writeIndex.load (std::memory_order_relaxed) };
+    if (write - readIndex.load (std::memory_order_acquire) >= ringSize)
+    {
+        droppedRecords.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring[write & (ringSize - 1)] = { ticks, (juce::int16) voiceId, stage };
+    writeIndex.store (write + 1, std::memory_order_release);
+}
+
+StageProfiler::Report StageProfiler::getStatisticsAndReset()
+{
+    std::array<std::vector<double>, (size_t) ProfilerStage::numStages> stageMicros;
+    std::map<int, std::vector<double>> voiceMicros;
+
+    const auto write { writeIndex.load (std::memory_order_acquire) };
+    auto read { readIndex.load (std::memory_order_relaxed) };
+
+    for (; read != write; ++read)
+    {
+        const auto& r { ring[read & (ringSize - 1)] };
+        const auto micros { (double) r.ticks * ticksToMicros };
+
+        stageMicros[(size_t) r.stage].push_back (micros);
+        if (r.stage == ProfilerStage::voice)
+            voiceMicros[r.voiceId].push_back (micros);
+    }
+
+    readIndex.store (read, std::memory_order_release);
+
+    Report report;
+    for (size_t i = 0; i < stageMicros.size(); ++i)
+        report.stages[i] = computeStatistics (stageMicros[i]);
+
+    for (auto& [voiceId, micros] : voiceMicros)
+        report.voices[voiceId] = computeStatistics (micros);
+
+    report.droppedRecords = droppedRecords.exchange (0, std::memory_order_relaxed);
+
+    return report;
+}
+
+juce::Result StageProfiler::dumpToFile (const juce::File& file)
+{
+    if (! file.replaceWithText (getStatisticsAndReset().toString()))
+        return juce::Result::fail ("Could not write " + file.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+juce::String StageProfiler::getStageName (ProfilerStage stage)
+{
+    switch (stage)
+    {
+        case ProfilerStage::processBlock: return "processBlock";
+        case ProfilerStage::midi:         return "midi";
+        case ProfilerStage::voices:       return "voices";
+        case ProfilerStage::voice:        return "voice";
+        case ProfilerStage::oscillators:  return "oscillators";
+        case ProfilerStage::filter:       return "filter";
+        case ProfilerStage::envelopes:    return "envelopes";
+        case ProfilerStage::effects:      return "effects";
+        case ProfilerStage::masterGain:   return "masterGain";
+        case ProfilerStage::numStages:
+        default: jassertfalse; return {};
+    }
+}
+
+juce::String StageProfiler::Report::toString() const
+{
+    juce::StringArray lines;
+    lines.add (juce::String ("stage").paddedRight (' ', 14) + "   calls    min us    avg us    max us    p99 us");
+
+    for (size_t i = 0; i < stages.size(); ++i)
+        if (stages[i].numCalls > 0)
+            lines.add (formatLine (getStageName ((ProfilerStage) i), stages[i]));
+
+    for (const auto& [voiceId, stats] : voices)
+        lines.add (formatLine ("voice " + juce::String (voiceId), stats));
+
+    if (droppedRecords > 0)
+        lines.add ("dropped records: " + juce::String (droppedRecords));
+
+    return lines.joinIntoString ("\n");
+}
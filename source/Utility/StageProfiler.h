@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_core/juce_core.h"
+
+#include <array>
+#include <atomic>
+#include <map>
+
+/** The stages of the render that StageProfiler times. */
+enum class ProfilerStage : juce::uint8
+{
+    processBlock = 0,
+    midi,
+    voices,     // all voices, from the synth's point of view
+    voice,      // a single voice, with its id in the record
+    oscillators,
+    filter,     // cutoff modulation and the filter itself
+    envelopes,  // amp envelope and output level tracking
+    effects,
+    masterGain,
+    numStages
+};
+
+/** Lock-free stage timing for the render path, always compiled in and toggled at runtime.
+*
+*   The audio thread times stages with StageTimer, which pushes one record per stage and render call
+*   into a single-producer, single-consumer ring. The message thread drains that ring with
+*   getStatisticsAndReset() and gets min/avg/max/p99 per stage, plus the same per voice.
+*   When disabled, a StageTimer costs a single branch on an atomic flag.
+*/
+class StageProfiler
+{
+public:
+    StageProfiler();
+
+    void setEnabled (bool shouldBeEnabled) noexcept { enabled.store (shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load (std::memory_order_relaxed); }
+
+    /** Audio thread only. Drops the record if the message thread isn't keeping up. */
+    void record (ProfilerStage stage, int voiceId, juce::int64 ticks) noexcept;
+
+    struct Statistics
+    {
+        int numCalls { 0 };
+        double minMicros { 0. }, averageMicros { 0. }, maxMicros { 0. }, p99Micros { 0. };
+    };
+
+    struct Report
+    {
+        std::array<Statistics, (size_t) ProfilerStage::numStages> stages;
+        std::map<int, Statistics> voices;
+        int droppedRecords { 0 };
+
+        /** One line per stage then per voice, in microseconds. */
+        juce::String toString() const;
+    };
+
+    /** Message thread only. Returns the statistics for everything recorded since the last call. */
+    Report getStatisticsAndReset();
+
+    /** Message thread only. Writes getStatisticsAndReset() to file as text. */
+    juce::Result dumpToFile (const juce::File& file);
+
+    static juce::String getStageName (ProfilerStage stage);
+
+private:
+    struct Record
+    {
+        juce::int64 ticks;
+        juce::int16 voiceId;
+        ProfilerStage stage;
+    };
+
+    //enough for a few seconds of records at small buffer sizes, we get drained a few times a second
+    static constexpr size_t ringSize { 1 << 15 };
+
+    std::atomic<bool> enabled { false };
+
+    std::array<Record, ringSize> ring;
+    std::atomic<size_t> writeIndex { 0 }, readIndex { 0 };
+    std::atomic<int> droppedRecords { 0 };
+
+    const double ticksToMicros;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageProfiler)
+};
+
+//=====================================================================================================================
+
+/** Accumulates the time spent in each stage over a render call, and records it when going out of scope.
+*   Call lap() right after the work for a stage is done; the time since the previous lap (or since construction)
+*   is added to that stage. Pass a null profiler to do nothing at all.
+*/
+class StageTimer
+{
+public:
+    StageTimer (StageProfiler* stageProfiler, int voice = -1) noexcept
+        : profiler (stageProfiler != nullptr && stageProfiler->isEnabled() ? stageProfiler : nullptr)
+        , voiceId (voice)
+    {
+        if (profiler != nullptr)
+            start = last = juce::Time::getHighResolutionTicks();
+    }
+
+    ~StageTimer()
+    {
+        if (profiler == nullptr)
+            return;
+
+        for (size_t i = 0; i < ticks.size(); ++i)
+            if (ticks[i] > 0)
+                profiler->record ((ProfilerStage) i, voiceId, ticks[i]);
+
+        //a voice's whole render call is what gets attributed to it, including what isn't lapped
+        if (voiceId >= 0)
+            profiler->record (ProfilerStage::voice, voiceId, juce::Time::getHighResolutionTicks() - start);
+    }
+
+    void lap (ProfilerStage stage) noexcept
+    {
+        if (profiler == nullptr)
+            return;
+
+        const auto now { juce::Time::getHighResolutionTicks() };
+        ticks[(size_t) stage] += now - last;
+        last = now;
+    }
+
+private:
+    StageProfiler* profiler;
+    const int voiceId;
+
+    juce::int64 start { 0 }, last { 0 };
+    std::array<juce::int64, (size_t) ProfilerStage::numStages> ticks {};
+
+    JUCE_DECLARE_NON_COPYABLE (StageTimer)
+};
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "TraceLog.h"
+
+TraceLog& TraceLog::getInstance()
+{
+    static TraceLog instance (getDefaultFile());
+    return instance;
+}
+
+juce::File TraceLog::getDefaultFile()
+{
+    return juce::File::getSpecialLocation (juce::File::tempDirectory).getChildFile ("ProPhatTrace.bin");
+}
+
+TraceLog::TraceLog (const juce::File& file)
+{
+    //start clean every time, a trace from a previous run would have unrelated timestamps
+    if (! file.deleteFile())
+    {
+        jassertfalse;
+        return;
+    }
+
+    {
+        juce::FileOutputStream stream (file);
+        if (! stream.openedOk() || ! stream.writeRepeatedByte (0, sizeof (TraceLogData)))
+        {
+            jassertfalse;
+            return;
+        }
+    }
+
+    mapping = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readWrite, false);
+    if (mapping->getData() == nullptr || mapping->getSize() != sizeof (TraceLogData))
+    {
+        jassertfalse; // Failed to map the log memory!
+        mapping.reset();
+        return;
+    }
+
+    //the file is all zeros, which is a valid empty ring, so we only need the header
+    data = static_cast<TraceLogData*> (mapping->getData());
+    data->magic = TraceLogData::expectedMagic;
+    data->version = TraceLogData::expectedVersion;
+    data->numEvents = TraceLogData::capacity;
+}
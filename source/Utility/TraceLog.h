@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_core/juce_core.h"
+#include "Macros.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+/** What a TraceEvent is about. The meaning of its source and data fields depends on this. */
+enum class TraceEventType : juce::uint8
+{
+    processBlockBegin = 0,   // data1: numSamples, data2: number of midi events
+    processBlockEnd,
+    effectsBegin,            // data1: number of effect slots processed
+    effectsEnd,
+    midiEvent,               // data1: status byte, data2: first data byte | second data byte << 8
+    voiceStart,              // source: voice id, data1: note, data2: velocity [0, 127]
+    voiceRetrigger,          // source: voice id, data1: note, data2: velocity [0, 127]
+    voiceRelease,            // source: voice id
+    voiceSteal,              // source: stolen voice id, data1: id of the ghost voice it now plays from, or -1
+    voiceKill,               // source: voice id
+    effectTransitionBegin,   // source: effect slot, data1: previous EffectType, data2: next EffectType
+    effectTransitionReverse, // source: effect slot, data1: previous EffectType, data2: next EffectType
+    effectTransitionEnd,     // source: effect slot, data1: previous EffectType, data2: next EffectType
+    numTypes
+};
+
+/** One record of the trace ring, as laid out in the mapped file. */
+struct TraceEvent
+{
+    //index + 1 of the event in the ring once it's completely written, 0 while it's being written
+    std::atomic<juce::uint64> sequence;
+    juce::uint64 timestampNs;
+    juce::int32 data1, data2;
+    juce::int16 source;
+    TraceEventType type;
+    juce::uint8 reserved[5];
+};
+
+/** The whole mapped file: a header and a ring of events. Readers use sequence to find the valid events and their order. */
+struct TraceLogData
+{
+    static constexpr std::array<char, 8> expectedMagic { 'P', 'H', 'A', 'T', 'T', 'R', 'C', '\0' };
+    static constexpr juce::uint32 expectedVersion { 1 };
+    static constexpr juce::uint32 capacity { 1 << 16 };
+
+    std::array<char, 8> magic;
+    juce::uint32 version;
+    juce::uint32 numEvents;
+    std::atomic<juce::uint64> writeIndex;
+
+    std::array<TraceEvent, capacity> events;
+};
+
+static_assert (sizeof (TraceEvent) == 32);
+static_assert (std::atomic<juce::uint64>::is_always_lock_free);
+static_assert (std::is_standard_layout_v<TraceLogData>);
+
+/** A nanosecond resolution, lock-free trace of what happens on the audio thread, written to a memory-mapped
+*   file so it survives crashes and can be read while we're running. Any number of threads can write to it.
+*   Turn it on with ENABLE_TRACE_LOG, write to it with the TRACE_EVENT macro, and convert the file
+*   to a Chrome trace with the ProPhatTrace tool to look at it in Perfetto or chrome://tracing.
+*/
+class TraceLog
+{
+public:
+    /** Maps getDefaultFile() on first use, so call this once from the message thread before the audio starts. */
+    static TraceLog& getInstance();
+
+    /** ProPhatTrace.bin in the temp directory. */
+    static juce::File getDefaultFile();
+
+    void write (TraceEventType type, int source = -1, int data1 = 0, int data2 = 0) noexcept
+    {
+        if (data == nullptr)
+            return;
+
+        const auto index { data->writeIndex.fetch_add (1, std::memory_order_relaxed) };
+        auto& event { data->events[index & (TraceLogData::capacity - 1)] };
+
+        event.sequence.store (0, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        event.timestampNs = getTimestampNs();
+        event.data1 = data1;
+        event.data2 = data2;
+        event.source = (juce::int16) source;
+        event.type = type;
+
+        event.sequence.store (index + 1, std::memory_order_release);
+    }
+
+    static juce::uint64 getTimestampNs() noexcept
+    {
+        return (juce::uint64) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    explicit TraceLog (const juce::File& file);
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    TraceLogData* data { nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE (TraceLog)
+};
+
+#if ENABLE_TRACE_LOG
+ #define TRACE_EVENT(...) TraceLog::getInstance().write (__VA_ARGS__)
+#else
+ #define TRACE_EVENT(...) ((void) 0)
+#endif
@@ -0,0 +1,39 @@
+#include <DSP/ProPhatProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("PhatVerb sounds like juce::Reverb", "[PhatVerb]")
+{
+    const double sampleRate = 48000.0;
+    const int    blockSize  = 500; //not a multiple of PhatVerb's internal chunk size
+    const int    numBlocks  = 200;
+
+    PhatVerb<float> phatVerb;
+    juce::Reverb    juceVerb;
+
+    phatVerb.setSampleRate (sampleRate);
+    juceVerb.setSampleRate (sampleRate);
+
+    juce::AudioBuffer<float> phatBuffer (2, blockSize), juceBuffer (2, blockSize);
+    juce::Random             random (1234);
+
+    float maxError = 0.f;
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        //a few blocks of noise, then let the tail ring
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                phatBuffer.setSample (c, i, b < 10 ? random.nextFloat() * 2.f - 1.f : 0.f);
+
+        juceBuffer.makeCopyOf (phatBuffer);
+
+        phatVerb.processStereo (phatBuffer.getWritePointer (0), phatBuffer.getWritePointer (1), blockSize);
+        juceVerb.processStereo (juceBuffer.getWritePointer (0), juceBuffer.getWritePointer (1), blockSize);
+
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                maxError = std::max (maxError, std::abs (phatBuffer.getSample (c, i) - juceBuffer.getSample (c, i)));
+    }
+
+    REQUIRE (maxError < 1e-4f);
+}
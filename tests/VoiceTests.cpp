@@ -0,0 +1,68 @@
+#include <DSP/ProPhatProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("Stolen voice fades out over killRampSamples", "[voice]")
+{
+    const double sampleRate = 48000.0;
+    const int    blockSize  = Constants::renderQuantum;
+
+    //the processor is only there for its state
+    ProPhatProcessor processor;
+    std::set<int>    voicesBeingKilled;
+
+    //a synth with a single voice, so we can look at that voice's output on its own
+    LockFreeSynthesiser synth;
+    auto* voice = new ProPhatVoice<float> (processor.state, 0, &voicesBeingKilled);
+    synth.addVoice (voice);
+    synth.addSound (new ProPhatSound());
+    synth.setCurrentPlaybackSampleRate (sampleRate);
+    voice->prepare ({ sampleRate, (juce::uint32) juce::jmax (blockSize, Constants::killRampSamples), 2 });
+
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    const auto renderBlock = [&]
+    {
+        buffer.clear();
+        voice->renderNextBlock (buffer, 0, blockSize);
+    };
+
+    //let the note get through its attack and decay, and measure its level
+    synth.noteOn (1, 60, 1.f);
+    for (int i = 0; i < (int) sampleRate / blockSize; ++i)
+        renderBlock();
+
+    auto peakBeforeFade { 0.f };
+    for (int i = 0; i < 20; ++i)
+    {
+        renderBlock();
+        peakBeforeFade = std::max (peakBeforeFade, buffer.getMagnitude (0, blockSize));
+    }
+    REQUIRE (peakBeforeFade > 0.f);
+
+    //this is what the synth does to a stolen voice when it hands it off to the ghost pool
+    voice->startFadeOut();
+
+    std::vector<float> fadedOutput;
+    while (fadedOutput.size() < (size_t) Constants::killRampSamples + (size_t) blockSize)
+    {
+        renderBlock();
+        fadedOutput.insert (fadedOutput.end(), buffer.getReadPointer (0), buffer.getReadPointer (0) + blockSize);
+
+        //the fade must span several render calls, not be done in the first one
+        if (fadedOutput.size() < (size_t) Constants::killRampSamples)
+            REQUIRE (voice->isVoiceActive());
+    }
+
+    //every sample stays under the linear ramp applied to the voice's level, with a little room for the waveform
+    //and the filter, so there's no jump anywhere, and the last samples of the fade are already almost silent
+    for (size_t i = 0; i < (size_t) Constants::killRampSamples; ++i)
+    {
+        const auto rampGain { (float) (Constants::killRampSamples - (int) i) / (float) Constants::killRampSamples };
+        REQUIRE (std::abs (fadedOutput[i]) <= peakBeforeFade * rampGain * 1.1f + 1e-6f);
+    }
+
+    //and the voice is silent and free once the fade is over
+    for (size_t i = (size_t) Constants::killRampSamples; i < fadedOutput.size(); ++i)
+        REQUIRE (fadedOutput[i] == 0.f);
+
+    REQUIRE_FALSE (voice->isVoiceActive());
+}
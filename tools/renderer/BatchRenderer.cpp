@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include <chrono>
+#include <thread>
+
+void BatchRenderer::WorkQueue::push (int jobIndex)
+{
+    const std::scoped_lock lock (mutex);
+    jobIndices.push_back (jobIndex);
+}
+
+std::optional<int> BatchRenderer::WorkQueue::popBack()
+{
+    const std::scoped_lock lock (mutex);
+    if (jobIndices.empty())
+        return {};
+
+    const auto jobIndex { jobIndices.back() };
+    jobIndices.pop_back();
+    return jobIndex;
+}
+
+std::optional<int> BatchRenderer::WorkQueue::stealFront()
+{
+    const std::scoped_lock lock (mutex);
+    if (jobIndices.empty())
+        return {};
+
+    const auto jobIndex { jobIndices.front() };
+    jobIndices.pop_front();
+    return jobIndex;
+}
+
+//=====================================================================================================================
+
+BatchRenderer::BatchRenderer (const RenderSettings& renderSettings, int numThreads)
+    : settings (renderSettings)
+{
+    jassert (numThreads > 0);
+
+    for (auto i = 0; i < numThreads; ++i)
+        queues.push_back (std::make_unique<WorkQueue>());
+}
+
+std::vector<BatchJob> BatchRenderer::makeJobs (const juce::Array<juce::File>& presetFiles, const juce::Array<juce::File>& midiFiles, const juce::File& outputDirectory)
+{
+    std::vector<BatchJob> jobs;
+    jobs.reserve ((size_t) (presetFiles.size() * midiFiles.size()));
+
+    for (const auto& preset : presetFiles)
+        for (const auto& midi : midiFiles)
+            jobs.push_back ({ preset, midi, outputDirectory.getChildFile (preset.getFileNameWithoutExtension() + " - " + midi.getFileNameWithoutExtension() + ".wav") });
+
+    return jobs;
+}
+
+std::vector<BatchJobResult> BatchRenderer::run (const std::vector<BatchJob>& jobs)
+{
+    std::vector<BatchJobResult> results (jobs.size());
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+        queues[i % queues.size()]->push ((int) i);
+
+    {
+        std::vector<std::jthread> workers;
+        for (auto i = 0; i < (int) queues.size(); ++i)
+            workers.emplace_back ([this, i, &jobs, &results] { runWorker (i, jobs, results); });
+    }
+
+    return results;
+}
+
+std::optional<int> BatchRenderer::findJob (int workerIndex)
+{
+    if (const auto jobIndex { queues[(size_t) workerIndex]->popBack() })
+        return jobIndex;
+
+    //start stealing from our neighbour, so the thieves don't all go for the same queue
+    for (size_t i = 1; i < queues.size(); ++i)
+        if (const auto jobIndex { queues[((size_t) workerIndex + i) % queues.size()]->stealFront() })
+            return jobIndex;
+
+    return {};
+}
+
+void BatchRenderer::runWorker (int workerIndex, const std::vector<BatchJob>& jobs, std::vector<BatchJobResult>& results)
+{
+    OfflineRenderer renderer (settings);
+
+    //nothing ever gets added to the queues once we've started, so once they're all empty we're done
+    while (const auto jobIndex { findJob (workerIndex) })
+    {
+        const auto& job { jobs[(size_t) *jobIndex] };
+        auto&       jobResult { results[(size_t) *jobIndex] };
+
+        const auto start { std::chrono::steady_clock::now() };
+        jobResult.result      = renderer.render (job.presetFile, job.midiFile, job.outputFile, jobResult.stats);
+        jobResult.wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        jobResult.workerIndex = workerIndex;
+    }
+}
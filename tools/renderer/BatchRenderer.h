@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OfflineRenderer.h"
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/** One preset rendered with one midi file. */
+struct BatchJob
+{
+    juce::File presetFile;
+    juce::File midiFile;
+    juce::File outputFile;
+};
+
+struct BatchJobResult
+{
+    juce::Result result { juce::Result::ok() };
+    RenderStats  stats;
+
+    //the whole job, including loading the inputs and writing the wav
+    double wallSeconds { 0. };
+    int    workerIndex { -1 };
+};
+
+/** Renders a list of jobs in parallel. Each worker renders one job at a time and streams it to its own wav,
+*   so memory use only depends on the number of threads, not on the number or length of the jobs.
+*
+*   Jobs are dealt out round robin to per-worker queues. A worker takes jobs from the back of its own queue,
+*   and once that's empty it steals from the front of the others', so short jobs don't leave threads idle while
+*   another one still has a backlog. Jobs are whole renders, so a mutex per queue is plenty.
+*/
+class BatchRenderer
+{
+public:
+    BatchRenderer (const RenderSettings& renderSettings, int numThreads);
+
+    /** Renders all the jobs, and returns once they're done. The result at index i is for jobs[i]. */
+    std::vector<BatchJobResult> run (const std::vector<BatchJob>& jobs);
+
+    /** Every preset with every midi file, rendered to "<preset> - <midi>.wav" in outputDirectory. */
+    static std::vector<BatchJob> makeJobs (const juce::Array<juce::File>& presetFiles, const juce::Array<juce::File>& midiFiles, const juce::File& outputDirectory);
+
+private:
+    class WorkQueue
+    {
+    public:
+        void push (int jobIndex);
+        std::optional<int> popBack();
+        std::optional<int> stealFront();
+
+    private:
+        std::mutex      mutex;
+        std::deque<int> jobIndices;
+    };
+
+    std::optional<int> findJob (int workerIndex);
+    void               runWorker (int workerIndex, const std::vector<BatchJob>& jobs, std::vector<BatchJobResult>& results);
+
+    RenderSettings settings;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+};
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+RenderSettings parseSettings (const juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    if (args.containsOption ("--sample-rate"))
+        settings.sampleRate = args.getValueForOption ("--sample-rate").getDoubleValue();
+
+    if (args.containsOption ("--block-size"))
+        settings.blockSize = args.getValueForOption ("--block-size").getIntValue();
+
+    if (args.containsOption ("--bits"))
+        settings.bitDepth = args.getValueForOption ("--bits").getIntValue();
+
+    if (args.containsOption ("--max-tail"))
+        settings.maxTailSeconds = args.getValueForOption ("--max-tail").getDoubleValue();
+
+    if (args.containsOption ("--precision"))
+    {
+        const auto precision { args.getValueForOption ("--precision") };
+        if (precision != "float" && precision != "double")
+            juce::ConsoleApplication::fail ("--precision must be float or double");
+
+        settings.doublePrecision = precision == "double";
+    }
+
+    if (settings.sampleRate < 8000. || settings.sampleRate > 768000.)
+        juce::ConsoleApplication::fail ("--sample-rate must be between 8000 and 768000");
+
+    if (settings.blockSize < 1 || settings.blockSize > 65536)
+        juce::ConsoleApplication::fail ("--block-size must be between 1 and 65536");
+
+    if (settings.bitDepth != 16 && settings.bitDepth != 24 && settings.bitDepth != 32)
+        juce::ConsoleApplication::fail ("--bits must be 16, 24 or 32");
+
+    if (settings.maxTailSeconds < 0.)
+        juce::ConsoleApplication::fail ("--max-tail can't be negative");
+
+    return settings;
+}
+
+void renderOne (const juce::ArgumentList& args)
+{
+    const auto presetFile { args.getExistingFileForOption ("--preset") };
+    const auto midiFile { args.getExistingFileForOption ("--midi") };
+    const auto outputFile { args.getFileForOption ("--output") };
+    const auto settings { parseSettings (args) };
+
+    OfflineRenderer renderer (settings);
+    RenderStats     stats;
+    if (const auto result { renderer.render (presetFile, midiFile, outputFile, stats) }; result.failed())
+        juce::ConsoleApplication::fail (result.getErrorMessage());
+
+    std::cout << "Rendered " << stats.audioSeconds << " s of audio to " << outputFile.getFullPathName() << "\n"
+              << "Processing took " << stats.processSeconds << " s over " << stats.numBlocks << " blocks of " << settings.blockSize
+              << " samples at " << settings.sampleRate << " Hz, in " << (settings.doublePrecision ? "double" : "float") << " precision\n"
+              << "Real-time factor: " << stats.getRealTimeFactor();
+
+    if (stats.getRealTimeFactor() > 0.)
+        std::cout << " (" << 1. / stats.getRealTimeFactor() << "x faster than real time)";
+
+    std::cout << std::endl;
+}
+/** A single file, or all the files in a directory that match the wildcard. */
+juce::Array<juce::File> findInputFiles (const juce::ArgumentList& args, juce::StringRef option, juce::StringRef wildcard)
+{
+    const auto path { args.getFileForOption (option) };
+    if (path.existsAsFile())
+        return { path };
+
+    if (! path.isDirectory())
+        juce::ConsoleApplication::fail (path.getFullPathName() + " doesn't exist");
+
+    auto files { path.findChildFiles (juce::File::findFiles, false, wildcard) };
+    files.sort();
+
+    if (files.isEmpty())
+        juce::ConsoleApplication::fail ("No input files in " + path.getFullPathName());
+
+    return files;
+}
+
+void renderBatch (const juce::ArgumentList& args)
+{
+    const auto presetFiles { findInputFiles (args, "--presets", "*") };
+    const auto midiFiles { findInputFiles (args, "--midi", "*.mid;*.midi") };
+    const auto outputDirectory { args.getFileForOption ("--output-dir") };
+    const auto settings { parseSettings (args) };
+
+    auto numThreads { juce::SystemStats::getNumCpus() };
+    if (args.containsOption ("--threads"))
+        numThreads = args.getValueForOption ("--threads").getIntValue();
+
+    if (numThreads < 1)
+        juce::ConsoleApplication::fail ("--threads must be at least 1");
+
+    if (const auto result { outputDirectory.createDirectory() }; result.failed())
+        juce::ConsoleApplication::fail (result.getErrorMessage());
+
+    const auto jobs { BatchRenderer::makeJobs (presetFiles, midiFiles, outputDirectory) };
+    numThreads = juce::jmin (numThreads, (int) jobs.size());
+
+    const auto start { std::chrono::steady_clock::now() };
+    const auto results { BatchRenderer (settings, numThreads).run (jobs) };
+    const auto wallSeconds { std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count() };
+
+    //per-job summary
+    std::cout << std::fixed << std::setprecision (3);
+    std::cout << std::left << std::setw (48) << "job" << std::right << std::setw (8) << "worker" << std::setw (12) << "audio s"
+              << std::setw (12) << "process s" << std::setw (12) << "wall s" << std::setw (10) << "RTF" << "\n";
+
+    auto totalAudioSeconds { 0. };
+    auto totalProcessSeconds { 0. };
+    auto numFailed { 0 };
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto& jobResult { results[i] };
+        std::cout << std::left << std::setw (48) << jobs[i].outputFile.getFileNameWithoutExtension() << std::right;
+
+        if (jobResult.result.failed())
+        {
+            std::cout << "  FAILED: " << jobResult.result.getErrorMessage() << "\n";
+            ++numFailed;
+            continue;
+        }
+
+        std::cout << std::setw (8) << jobResult.workerIndex << std::setw (12) << jobResult.stats.audioSeconds << std::setw (12) << jobResult.stats.processSeconds
+                  << std::setw (12) << jobResult.wallSeconds << std::setw (10) << jobResult.stats.getRealTimeFactor() << "\n";
+
+        totalAudioSeconds += jobResult.stats.audioSeconds;
+        totalProcessSeconds += jobResult.stats.processSeconds;
+    }
+
+    //throughput is audio rendered per second of wall time, over all threads
+    std::cout << "\n"
+              << jobs.size() - (size_t) numFailed << " of " << jobs.size() << " jobs rendered on " << numThreads << " threads in " << wallSeconds << " s\n"
+              << "Rendered " << totalAudioSeconds << " s of audio, spending " << totalProcessSeconds << " s in processBlock\n"
+              << "Throughput: " << (wallSeconds > 0. ? totalAudioSeconds / wallSeconds : 0.) << " s of audio per second" << std::endl;
+
+    if (numFailed > 0)
+        juce::ConsoleApplication::fail (juce::String (numFailed) + " jobs failed");
+}
+} // namespace
+
+int main (int argc, char* argv[])
+{
+    //the processor's state needs a message manager
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand ("--help|-h", "Usage: ProPhatRender --preset=<file> --midi=<file.mid> --output=<file.wav> [options]", true);
+    app.addDefaultCommand ({ "",
+                             "--preset=<file> --midi=<file.mid> --output=<file.wav> [options]",
+                             "Renders a midi file through a ProPhat preset into a wav file.",
+                             "Options:\n"
+                             "  --sample-rate=<Hz>          defaults to 48000\n"
+                             "  --block-size=<samples>      defaults to 512\n"
+                             "  --precision=<float|double>  defaults to float\n"
+                             "  --bits=<16|24|32>           wav bit depth, 32 being float. Defaults to 24\n"
+                             "  --max-tail=<seconds>        how long to let the sound ring out after the midi file ends. Defaults to 30",
+                             renderOne });
+
+    app.addCommand ({ "--batch",
+                      "--batch --presets=<file|dir> --midi=<file|dir> --output-dir=<dir> [--threads=<n>] [options]",
+                      "Renders every preset with every midi file in parallel, one wav per pair.",
+                      "Takes the same options as a single render. --threads defaults to the number of cpus.",
+                      renderBatch });
+
+    return app.findAndRunCommand (argc, argv);
+}
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include <chrono>
+
+OfflineRenderer::OfflineRenderer (const RenderSettings& renderSettings)
+    : settings (renderSettings)
+{
+    jassert (settings.sampleRate > 0. && settings.blockSize > 0);
+}
+
+juce::Result OfflineRenderer::loadPreset (ProPhatProcessor& processor, const juce::File& presetFile)
+{
+    juce::MemoryBlock data;
+    if (! presetFile.loadFileAsData (data))
+        return juce::Result::fail ("Couldn't read preset " + presetFile.getFullPathName());
+
+    //setStateInformation() silently ignores anything it can't parse, so check it ourselves
+    if (juce::AudioProcessor::getXmlFromBinary (data.getData(), (int) data.getSize()) == nullptr)
+        return juce::Result::fail (presetFile.getFullPathName() + " isn't a ProPhat preset");
+
+    processor.setStateInformation (data.getData(), (int) data.getSize());
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::loadMidiFile (const juce::File& midiFile, juce::MidiMessageSequence& sequence)
+{
+    juce::FileInputStream stream (midiFile);
+    juce::MidiFile        file;
+    if (! stream.openedOk() || ! file.readFrom (stream))
+        return juce::Result::fail ("Couldn't read midi file " + midiFile.getFullPathName());
+
+    //merge all tracks into one sequence, timestamped in seconds
+    file.convertTimestampTicksToSeconds();
+
+    sequence.clear();
+    for (auto t = 0; t < file.getNumTracks(); ++t)
+        sequence.addSequence (*file.getTrack (t), 0.);
+
+    sequence.sort();
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::render (const juce::File& presetFile, const juce::File& midiFile, const juce::File& outputFile, RenderStats& stats)
+{
+    stats = {};
+
+    ProPhatProcessor processor;
+    if (const auto result { loadPreset (processor, presetFile) }; result.failed())
+        return result;
+
+    juce::MidiMessageSequence sequence;
+    if (const auto result { loadMidiFile (midiFile, sequence) }; result.failed())
+        return result;
+
+    if (! outputFile.deleteFile())
+        return juce::Result::fail ("Couldn't overwrite " + outputFile.getFullPathName());
+
+    auto stream { std::make_unique<juce::FileOutputStream> (outputFile) };
+    if (! stream->openedOk())
+        return juce::Result::fail ("Couldn't create " + outputFile.getFullPathName());
+
+    const auto numChannels { processor.getTotalNumOutputChannels() };
+
+    juce::WavAudioFormat                     wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer { wavFormat.createWriterFor (stream.get(), settings.sampleRate, (unsigned int) numChannels, settings.bitDepth, {}, 0) };
+    if (writer == nullptr)
+        return juce::Result::fail ("Can't write a " + juce::String (settings.bitDepth) + " bit wav at " + juce::String (settings.sampleRate) + " Hz");
+
+    //the writer owns the stream now
+    juce::ignoreUnused (stream.release());
+
+    processor.setProcessingPrecision (settings.doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+    processor.setNonRealtime (true);
+    processor.setRateAndBufferSizeDetails (settings.sampleRate, settings.blockSize);
+    processor.prepareToPlay (settings.sampleRate, settings.blockSize);
+
+    if (settings.doublePrecision)
+        renderBlocks<double> (processor, sequence, *writer, stats);
+    else
+        renderBlocks<float> (processor, sequence, *writer, stats);
+
+    processor.releaseResources();
+
+    if (! writer->flush())
+        return juce::Result::fail ("Couldn't write " + outputFile.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+template <std::floating_point T>
+void OfflineRenderer::renderBlocks (ProPhatProcessor& processor, const juce::MidiMessageSequence& sequence, juce::AudioFormatWriter& writer, RenderStats& stats)
+{
+    const auto numChannels { processor.getTotalNumOutputChannels() };
+    const auto blockSize { settings.blockSize };
+
+    juce::AudioBuffer<T>     buffer (numChannels, blockSize);
+    juce::AudioBuffer<float> floatBuffer (numChannels, blockSize);
+    juce::MidiBuffer         midi;
+
+    const auto toSamples = [this] (double seconds) { return static_cast<juce::int64> (std::llround (seconds * settings.sampleRate)); };
+
+    const auto lastEventSample { sequence.getNumEvents() > 0 ? toSamples (sequence.getEndTime()) : juce::int64 { 0 } };
+    const auto maxSamples { lastEventSample + toSamples (settings.maxTailSeconds) };
+    const auto silenceHoldSamples { toSamples (Constants::idleHoldSeconds) };
+
+    auto nextEvent { 0 };
+    auto silentSamples { juce::int64 { 0 } };
+    auto blockStart { juce::int64 { 0 } };
+
+    //keep going until we're past the last event and the tail has died out
+    while (blockStart < maxSamples && (blockStart <= lastEventSample || silentSamples < silenceHoldSamples))
+    {
+        const auto blockEnd { blockStart + blockSize };
+
+        midi.clear();
+        for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+        {
+            const auto& message { sequence.getEventPointer (nextEvent)->message };
+            const auto  eventSample { toSamples (message.getTimeStamp()) };
+            if (eventSample >= blockEnd)
+                break;
+
+            if (! message.isMetaEvent())
+                midi.addEvent (message, (int) juce::jmax (juce::int64 { 0 }, eventSample - blockStart));
+        }
+
+        const auto processStart { std::chrono::steady_clock::now() };
+        processor.processBlock (buffer, midi);
+        stats.processSeconds += std::chrono::duration<double> (std::chrono::steady_clock::now() - processStart).count();
+
+        silentSamples = processor.isOutputSilent() ? silentSamples + blockSize : 0;
+
+        if constexpr (std::is_same_v<T, float>)
+        {
+            writer.writeFromAudioSampleBuffer (buffer, 0, blockSize);
+        }
+        else
+        {
+            floatBuffer.makeCopyOf (buffer, true);
+            writer.writeFromAudioSampleBuffer (floatBuffer, 0, blockSize);
+        }
+
+        blockStart = blockEnd;
+        ++stats.numBlocks;
+    }
+
+    stats.audioSeconds = static_cast<double> (blockStart) / settings.sampleRate;
+}
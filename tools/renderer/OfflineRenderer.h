@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <DSP/ProPhatProcessor.h>
+
+/** How an offline render is set up. */
+struct RenderSettings
+{
+    double sampleRate { 48000. };
+    int    blockSize { 512 };
+    bool   doublePrecision { false };
+
+    //16 and 24 bits write integer wavs, 32 bits writes a float wav
+    int bitDepth { 24 };
+
+    //once the midi file is done we keep rendering until the output goes silent, but never longer than this
+    double maxTailSeconds { 30. };
+};
+
+/** What an offline render took. */
+struct RenderStats
+{
+    double audioSeconds { 0. };
+
+    //only the time spent in processBlock, i.e. without reading the inputs and writing the wav
+    double processSeconds { 0. };
+
+    juce::int64 numBlocks { 0 };
+
+    /** Processing time over audio time, so under 1 means faster than real time. */
+    double getRealTimeFactor() const { return audioSeconds > 0. ? processSeconds / audioSeconds : 0.; }
+};
+
+/** Renders a standard midi file through a ProPhat preset into a wav file, without any host or audio device.
+*   The preset is the binary xml state that getStateInformation() writes, like the ones in assets/presets.
+*/
+class OfflineRenderer
+{
+public:
+    explicit OfflineRenderer (const RenderSettings& renderSettings);
+
+    /** Renders midiFile with presetFile into outputFile, which gets overwritten. The wav is written block by
+    *   block as we go, so memory use doesn't depend on the length of the render.
+    */
+    juce::Result render (const juce::File& presetFile, const juce::File& midiFile, const juce::File& outputFile, RenderStats& stats);
+
+    static juce::Result loadPreset (ProPhatProcessor& processor, const juce::File& presetFile);
+    static juce::Result loadMidiFile (const juce::File& midiFile, juce::MidiMessageSequence& sequence);
+
+private:
+    template <std::floating_point T>
+    void renderBlocks (ProPhatProcessor& processor, const juce::MidiMessageSequence& sequence, juce::AudioFormatWriter& writer, RenderStats& stats);
+
+    RenderSettings settings;
+};
@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    ProPhat is a virtual synthesizer inspired by the Prophet REV2.
+    Copyright (C) 2024 Vincent Berthiaume
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+  ==============================================================================
+*/
+
+#include "Utility/TraceLog.h"
+#include <iostream>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace
+{
+//chrome trace thread ids, so each kind of event gets its own track
+constexpr auto audioTrack { 1 };
+constexpr auto midiTrack { 2 };
+constexpr auto firstEffectSlotTrack { 10 };
+constexpr auto firstVoiceTrack { 100 };
+
+/** A copy of a TraceEvent, without the atomic, taken while the event wasn't being written. */
+struct EventSnapshot
+{
+    juce::uint64 sequence, timestampNs;
+    juce::int32 data1, data2;
+    juce::int16 source;
+    TraceEventType type;
+};
+
+/** Copies the event if it's completely written and hasn't been overwritten while we were copying it,
+    which is the read side of the seqlock in TraceLog::write().
+*/
+std::optional<EventSnapshot> readEvent (const TraceEvent& event)
+{
+    const auto sequence { event.sequence.load (std::memory_order_acquire) };
+    if (sequence == 0)
+        return std::nullopt;
+
+    const EventSnapshot snapshot { sequence, event.timestampNs, event.data1, event.data2, event.source, event.type };
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+    if (event.sequence.load (std::memory_order_relaxed) != sequence)
+        return std::nullopt;
+
+    return snapshot;
+}
+
+juce::String getEffectName (int effectType)
+{
+    switch (effectType)
+    {
+        case 0:  return "none";
+        case 1:  return "verb";
+        case 2:  return "chorus";
+        case 3:  return "phaser";
+        default: return "unknown";
+    }
+}
+
+juce::var makeEvent (const juce::String& name, const juce::String& phase, double timestampMicros, int track)
+{
+    auto* object { new juce::DynamicObject() };
+    object->setProperty ("name", name);
+    object->setProperty ("ph", phase);
+    object->setProperty ("ts", timestampMicros);
+    object->setProperty ("pid", 1);
+    object->setProperty ("tid", track);
+
+    //instant events are drawn on their thread's track rather than across the whole process
+    if (phase == "i")
+        object->setProperty ("s", "t");
+
+    return object;
+}
+
+juce::var makeTrackName (int track, const juce::String& name)
+{
+    auto event { makeEvent ("thread_name", "M", 0., track) };
+
+    auto* args { new juce::DynamicObject() };
+    args->setProperty ("name", name);
+    event.getDynamicObject()->setProperty ("args", args);
+
+    //keeps the tracks in a sensible order in the viewer
+    auto sortEvent { makeEvent ("thread_sort_index", "M", 0., track) };
+    auto* sortArgs { new juce::DynamicObject() };
+    sortArgs->setProperty ("sort_index", track);
+    sortEvent.getDynamicObject()->setProperty ("args", sortArgs);
+
+    return juce::Array<juce::var> { event, sortEvent };
+}
+
+void setArg (juce::var& event, const juce::Identifier& name, const juce::var& value)
+{
+    auto* object { event.getDynamicObject() };
+    if (! object->hasProperty ("args"))
+        object->setProperty ("args", new juce::DynamicObject());
+
+    object->getProperty ("args").getDynamicObject()->setProperty (name, value);
+}
+
+/** Returns the chrome trace event for one of ours, and adds the track it goes on to usedTracks. */
+juce::var convertEvent (const EventSnapshot& e, double timestampMicros, std::map<int, juce::String>& usedTracks)
+{
+    const auto voiceTrack { firstVoiceTrack + e.source };
+    const auto effectTrack { firstEffectSlotTrack + e.source };
+    const auto transitionName { getEffectName (e.data1) + " -> " + getEffectName (e.data2) };
+
+    juce::var event;
+    auto track { audioTrack };
+
+    switch (e.type)
+    {
+        case TraceEventType::processBlockBegin:
+            event = makeEvent ("processBlock", "B", timestampMicros, track);
+            setArg (event, "numSamples", e.data1);
+            setArg (event, "midiEvents", e.data2);
+            break;
+        case TraceEventType::processBlockEnd:
+            event = makeEvent ("processBlock", "E", timestampMicros, track);
+            break;
+        case TraceEventType::effectsBegin:
+            event = makeEvent ("effects", "B", timestampMicros, track);
+            setArg (event, "slots", e.data1);
+            break;
+        case TraceEventType::effectsEnd:
+            event = makeEvent ("effects", "E", timestampMicros, track);
+            break;
+        case TraceEventType::midiEvent:
+        {
+            track = midiTrack;
+
+            //we only keep the first 3 bytes, which isn't enough to rebuild a sysex message
+            const auto name { e.data1 == 0xf0 ? juce::String ("sysex") : juce::MidiMessage (e.data1, e.data2 & 0xff, (e.data2 >> 8) & 0xff).getDescription() };
+            event = makeEvent (name, "i", timestampMicros, track);
+            break;
+        }
+        case TraceEventType::voiceStart:
+        case TraceEventType::voiceRetrigger:
+            track = voiceTrack;
+            event = makeEvent (juce::String (e.type == TraceEventType::voiceStart ? "start " : "retrigger ") + juce::MidiMessage::getMidiNoteName (e.data1, true, true, 3),
+                               "i", timestampMicros, track);
+            setArg (event, "note", e.data1);
+            setArg (event, "velocity", e.data2);
+            break;
+        case TraceEventType::voiceRelease:
+            track = voiceTrack;
+            event = makeEvent ("release", "i", timestampMicros, track);
+            break;
+        case TraceEventType::voiceSteal:
+            track = voiceTrack;
+            event = makeEvent ("stolen", "i", timestampMicros, track);
+            setArg (event, "ghostVoice", e.data1);
+            break;
+        case TraceEventType::voiceKill:
+            track = voiceTrack;
+            event = makeEvent ("kill", "i", timestampMicros, track);
+            break;
+        case TraceEventType::effectTransitionBegin:
+            track = effectTrack;
+            event = makeEvent ("transition", "B", timestampMicros, track);
+            setArg (event, "effects", transitionName);
+            break;
+        case TraceEventType::effectTransitionReverse:
+            track = effectTrack;
+            event = makeEvent ("reverse to " + transitionName, "i", timestampMicros, track);
+            break;
+        case TraceEventType::effectTransitionEnd:
+            track = effectTrack;
+            event = makeEvent ("transition", "E", timestampMicros, track);
+            break;
+        case TraceEventType::numTypes:
+        default:
+            return {};
+    }
+
+    if (track >= firstVoiceTrack)
+        usedTracks[track] = "voice " + juce::String (e.source);
+    else if (track >= firstEffectSlotTrack)
+        usedTracks[track] = "effect slot " + juce::String (e.source);
+    else
+        usedTracks[track] = track == audioTrack ? "audio" : "midi";
+
+    return event;
+}
+
+void convert (const juce::ArgumentList& args)
+{
+    const auto input { args.containsOption ("--input") ? args.getExistingFileForOption ("--input") : TraceLog::getDefaultFile() };
+    const auto output { args.getFileForOption ("--output") };
+
+    juce::MemoryMappedFile mapping (input, juce::MemoryMappedFile::readOnly);
+    if (mapping.getData() == nullptr || mapping.getSize() != sizeof (TraceLogData))
+        juce::ConsoleApplication::fail ("Could not map " + input.getFullPathName() + ", or it isn't a trace file");
+
+    const auto& data { *static_cast<const TraceLogData*> (mapping.getData()) };
+    if (data.magic != TraceLogData::expectedMagic || data.version != TraceLogData::expectedVersion || data.numEvents != TraceLogData::capacity)
+        juce::ConsoleApplication::fail (input.getFullPathName() + " was written by a different version of the trace log");
+
+    //the ring may still be written to while we read it, so only keep events that are completely written
+    //and that belong to the current lap around the ring
+    const auto writeIndex { data.writeIndex.load (std::memory_order_acquire) };
+    const auto firstIndex { writeIndex > TraceLogData::capacity ? writeIndex - TraceLogData::capacity : 0 };
+
+    std::vector<EventSnapshot> events;
+    events.reserve (TraceLogData::capacity);
+
+    for (const auto& event : data.events)
+        if (const auto snapshot { readEvent (event) }; snapshot && snapshot->sequence > firstIndex && snapshot->sequence <= writeIndex)
+            events.push_back (*snapshot);
+
+    if (events.empty())
+        juce::ConsoleApplication::fail ("No events in " + input.getFullPathName());
+
+    std::sort (events.begin(), events.end(), [] (const auto& a, const auto& b) { return a.sequence < b.sequence; });
+
+    //timestamps are relative to the first event, in microseconds with nanosecond decimals
+    const auto startNs { events.front().timestampNs };
+
+    juce::Array<juce::var> traceEvents;
+    std::map<int, juce::String> usedTracks;
+
+    for (const auto& event : events)
+    {
+        const auto timestampMicros { (double) (event.timestampNs - startNs) / 1000. };
+        if (auto converted { convertEvent (event, timestampMicros, usedTracks) }; ! converted.isVoid())
+            traceEvents.add (converted);
+    }
+
+    for (const auto& [track, name] : usedTracks)
+        traceEvents.addArray (*makeTrackName (track, name).getArray());
+
+    auto root { std::make_unique<juce::DynamicObject>() };
+    root->setProperty ("traceEvents", traceEvents);
+    root->setProperty ("displayTimeUnit", "ns");
+
+    if (! output.replaceWithText (juce::JSON::toString (juce::var (root.release()), true)))
+        juce::ConsoleApplication::fail ("Could not write " + output.getFullPathName());
+
+    std::cout << "Wrote " << events.size() << " events to " << output.getFullPathName()
+              << ", open it in https://ui.perfetto.dev or chrome://tracing" << std::endl;
+
+    if (writeIndex > TraceLogData::capacity)
+        std::cout << "The ring wrapped around, the first " << writeIndex - TraceLogData::capacity << " events were overwritten" << std::endl;
+}
+} // namespace
+
+int main (int argc, char* argv[])
+{
+    juce::ConsoleApplication app;
+    app.addHelpCommand ("--help|-h", "Usage: ProPhatTrace --output=<file.json> [--input=<trace file>]", true);
+    app.addDefaultCommand ({ "",
+                             "--output=<file.json> [--input=<trace file>]",
+                             "Converts the trace written by a build with ENABLE_TRACE_LOG into Chrome trace json, for Perfetto.",
+                             "--input defaults to " + TraceLog::getDefaultFile().getFullPathName() + ", which can be read while the plugin is running.",
+                             convert });
+
+    return app.findAndRunCommand (argc, argv);
+}